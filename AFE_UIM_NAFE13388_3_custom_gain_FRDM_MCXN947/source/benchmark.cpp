@@ -0,0 +1,221 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license
+ */
+
+#include	"r01lib.h"
+#include	"afe/INL_LUT.h"
+#include	"afe/NAFE13388_UIM.h"
+#include	"afe/SpectrumAnalyzer.h"
+#include	"afe/unpack24.h"
+#include	"benchmark.h"
+#include	<string.h>
+#include	<math.h>
+
+constexpr int	bench_samples	= 1024;
+
+static int32_t	bench_data[ bench_samples ];
+
+static void bench_fill( void )
+{
+	//	sweep over full 24 bit range
+	
+	for ( auto i = 0; i < bench_samples; i++ )
+		bench_data[ i ]	= (int32_t)(((int64_t)i * 0xFFFFFF) / (bench_samples - 1)) - 0x800000;
+}
+
+void benchmark_inl_lut( PrintOutput& out )
+{
+	constexpr int32_t	measured[]	= { -8000000, -4000000, 0, 4000000, 8000000 };
+	constexpr int32_t	ideal[]		= { -8000120, -4000030, 15, 4000040, 8000110 };
+	constexpr int		n			= sizeof( measured ) / sizeof( int32_t );
+	
+	out.printf( "\r\n=== INL_LUT benchmark (%d samples) ===\r\n", bench_samples );
+
+	for ( auto s = 0; s <= INL_LUT::max_segments_log2; s += 2 )
+	{
+		INL_LUT		lut( s );
+		uint32_t	start;
+		uint32_t	single;
+		uint32_t	block;
+
+		lut.build( measured, ideal, n );
+
+		bench_fill();
+		start	= cycle_counter();
+		
+		for ( auto i = 0; i < bench_samples; i++ )
+			bench_data[ i ]	= lut.correct( bench_data[ i ] );
+		
+		single	= cycle_counter() - start;
+
+		bench_fill();
+		start	= cycle_counter();
+		lut.apply( bench_data, bench_samples );
+		block	= cycle_counter() - start;
+
+		out.printf( "  %2d segments : correct() %5.2f cycles/sample, apply() %5.2f cycles/sample\r\n", 
+					lut.nodes() - 1, 
+					(float)single / bench_samples, 
+					(float)block  / bench_samples 
+				  );
+	}
+}
+
+void benchmark_read_path( NAFE13388_UIM& afe, PrintOutput& out )
+{
+	using	raw_t	= NAFE13388_UIM::raw_t;
+
+	constexpr int	reads	= 1000;
+	AFE_base&		base	= afe;
+	volatile raw_t	sink;
+	uint32_t		start;
+	uint32_t		virtual_path;
+	uint32_t		static_path;
+
+	out.printf( "\r\n=== ADC read path benchmark (%d register reads) ===\r\n", reads );
+
+	start	= cycle_counter();
+
+	for ( auto i = 0; i < reads; i++ )
+		sink	= base.read<raw_t>( 0 );
+	
+	virtual_path	= cycle_counter() - start;
+
+	start	= cycle_counter();
+
+	for ( auto i = 0; i < reads; i++ )
+		sink	= afe.read<raw_t>( 0 );
+	
+	static_path		= cycle_counter() - start;
+
+	(void)sink;
+
+	out.printf( "  AFE_base::read() (virtual)  : %8.1f cycles/read\r\n", (float)virtual_path / reads );
+	out.printf( "  NAFE_Base::read() (static)  : %8.1f cycles/read\r\n", (float)static_path  / reads );
+	out.printf( "  difference                  : %8.1f cycles/read\r\n", ((float)virtual_path - (float)static_path) / reads );
+}
+
+void benchmark_spi( SPI& spi, PrintOutput& out )
+{
+	constexpr int		transactions	= 1000;
+	constexpr uint16_t	reg				= (0x7C << 1) | 0x4000;	//	PN2 read frame, harmless for the AFE
+	const uint8_t		frame[]			= { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF), 0xFF, 0xFF, 0xFF };
+	uint8_t				w[ sizeof( frame ) ];
+	uint8_t				r[ sizeof( frame ) ];
+	uint32_t			start;
+	uint32_t			sdk_path;
+	uint32_t			fast_path;
+
+	out.printf( "\r\n=== SPI transfer benchmark (%d x %d byte frames) ===\r\n", transactions, (int)sizeof( frame ) );
+
+	start	= cycle_counter();
+
+	for ( auto i = 0; i < transactions; i++ )
+	{
+		memcpy( w, frame, sizeof( frame ) );
+		spi.write( w, r, sizeof( frame ) );
+	}
+	
+	sdk_path	= cycle_counter() - start;
+
+	start	= cycle_counter();
+
+	for ( auto i = 0; i < transactions; i++ )
+		spi.write_fast( frame, r, sizeof( frame ) );
+	
+	fast_path	= cycle_counter() - start;
+
+	out.printf( "  SPI::write()      : %8.1f cycles/transaction, %8.0f transactions/s\r\n", (float)sdk_path  / transactions, (float)transactions * cycle_frequency() / sdk_path  );
+	out.printf( "  SPI::write_fast() : %8.1f cycles/transaction, %8.0f transactions/s\r\n", (float)fast_path / transactions, (float)transactions * cycle_frequency() / fast_path );
+}
+
+template<int N>
+static void bench_spectrum( NAFE13388_UIM& afe, PrintOutput& out )
+{
+	constexpr float			sample_rate	= 1000.0;
+	static SpectrumAnalyzer<NAFE13388_traits, N>	sa( afe, 0 );
+	uint32_t				start;
+	uint32_t				cycles;
+
+	//	50 Hz tone on a pseudo random noise
+
+	uint32_t	lfsr	= 0xACE1;
+
+	for ( auto i = 0; i < N; i++ )
+	{
+		lfsr	= (lfsr >> 1) ^ (-(lfsr & 1) & 0xB400);
+		sa.feed( (NAFE13388_UIM::raw_t)(100000 * sinf( 2 * 3.14159265f * 50 * i / sample_rate )) + (int32_t)(lfsr & 0xFF) - 128 );
+	}
+
+	start	= cycle_counter();
+	sa.analyze( sample_rate );
+	cycles	= cycle_counter() - start;
+
+	out.printf( "  %4d samples : %8lu cycles, %7.3f ms (%5.2f%% of block time at %.0f SPS)\r\n", 
+				N, 
+				cycles, 
+				cycles * 1000.0 / cycle_frequency(), 
+				cycles * 100.0 / cycle_frequency() / (N / sample_rate), 
+				sample_rate 
+			  );
+}
+
+void benchmark_spectrum( NAFE13388_UIM& afe, PrintOutput& out )
+{
+	out.printf( "\r\n=== SpectrumAnalyzer benchmark ===\r\n" );
+
+	bench_spectrum<  256 >( afe, out );
+	bench_spectrum< 1024 >( afe, out );
+	bench_spectrum< 4096 >( afe, out );
+}
+
+void benchmark_unpack( PrintOutput& out )
+{
+	static uint8_t	packed[ bench_samples * 3 ];
+	static int32_t	reference[ bench_samples ];
+	static float	scaled[ bench_samples ];
+	constexpr float	k			= 0.5;
+	uint32_t		start;
+	uint32_t		byte_path;
+	uint32_t		word_path;
+	uint32_t		scale_path;
+	int				mismatch	= 0;
+
+	out.printf( "\r\n=== 24 bit unpack benchmark (%d samples) ===\r\n", bench_samples );
+
+	//	full range sweep, packed big-endian like burst read data
+
+	bench_fill();
+
+	for ( auto i = 0; i < bench_samples; i++ )
+	{
+		packed[ i * 3     ]	= (uint8_t)(bench_data[ i ] >> 16);
+		packed[ i * 3 + 1 ]	= (uint8_t)(bench_data[ i ] >>  8);
+		packed[ i * 3 + 2 ]	= (uint8_t)(bench_data[ i ]      );
+	}
+
+	start		= cycle_counter();
+	unpack24_reference( packed, reference, bench_samples );
+	byte_path	= cycle_counter() - start;
+
+	start		= cycle_counter();
+	unpack24( packed, bench_data, bench_samples );
+	word_path	= cycle_counter() - start;
+
+	start		= cycle_counter();
+	unpack24_scale( packed, scaled, bench_samples, k );
+	scale_path	= cycle_counter() - start;
+
+	for ( auto i = 0; i < bench_samples; i++ )
+		if ( (bench_data[ i ] != reference[ i ]) || (scaled[ i ] != (float)reference[ i ] * k) )
+			mismatch++;
+
+	const float	us	= 1e6 / cycle_frequency();
+
+	out.printf( "  unpack24_reference() : %5.2f cycles/sample, %6.2f samples/us\r\n", (float)byte_path  / bench_samples, bench_samples / (byte_path  * us) );
+	out.printf( "  unpack24()           : %5.2f cycles/sample, %6.2f samples/us\r\n", (float)word_path  / bench_samples, bench_samples / (word_path  * us) );
+	out.printf( "  unpack24_scale()     : %5.2f cycles/sample, %6.2f samples/us\r\n", (float)scale_path / bench_samples, bench_samples / (scale_path * us) );
+	out.printf( "  bit-exact check      : %s (%d mismatch)\r\n", mismatch ? "FAIL" : "pass", mismatch );
+}
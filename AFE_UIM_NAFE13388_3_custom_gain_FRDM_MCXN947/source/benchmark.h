@@ -0,0 +1,19 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef NAFE_BENCHMARK_H
+#define NAFE_BENCHMARK_H
+
+#include	"PrintOutput.h"
+#include	"afe/NAFE13388_UIM.h"
+
+void	benchmark_inl_lut( PrintOutput& out );
+void	benchmark_read_path( NAFE13388_UIM& afe, PrintOutput& out );
+void	benchmark_spi( SPI& spi, PrintOutput& out );
+void	benchmark_spectrum( NAFE13388_UIM& afe, PrintOutput& out );
+void	benchmark_unpack( PrintOutput& out );
+
+#endif	//	NAFE_BENCHMARK_H
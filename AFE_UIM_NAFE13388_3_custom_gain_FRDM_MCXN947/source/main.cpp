@@ -10,6 +10,7 @@
 #include	<array>
 
 #include	"PrintOutput.h"
+#include	"benchmark.h"
 
 SPI				spi( D11, D12, D13, D10 );	//	MOSI, MISO, SCLK, CS
 NAFE13388_UIM	afe( spi );
@@ -77,11 +78,20 @@ int main( void )
 	spi.frequency( 1000'000 );
 	spi.mode( 1 );
 
-	afe.begin();
+	if ( afe.begin() )
+		panic( "NAFE13388 couldn't get ready. Check power supply or pin conections\r\n" );
 	
 	out.printf( "part number   = %04lX (revision: %01X)\r\n", afe.part_number(), afe.revision_number() );
 	out.printf( "serial number = %llX\r\n", afe.serial_number() );
 	out.printf( "die temperature = %f℃\r\n", afe.temperature() );
+
+#if 0
+	benchmark_inl_lut( out );
+	benchmark_read_path( afe, out );
+	benchmark_spi( spi, out );
+	benchmark_spectrum( afe, out );
+	benchmark_unpack( out );
+#endif
 	
 	//
 	//	logical channels setting
@@ -143,7 +153,7 @@ int main( void )
 
 	raw_t			data;
 	long			count		= 0;
-	constexpr float read_delay	= 0.01;
+	constexpr float read_delay	= NAFE13388_UIM::auto_delay;
 
 	while ( true )
 	{
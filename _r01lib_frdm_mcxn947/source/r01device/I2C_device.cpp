@@ -43,13 +43,16 @@ int I2C_device::rx( uint8_t *data, uint16_t size )
 
 int I2C_device::reg_w( uint8_t reg_adr, const uint8_t *data, uint16_t size )
 {
-	uint8_t buffer[ size + 1 ];
+	uint8_t buffer[ max_reg_w_size + 1 ];
+	
+	if ( max_reg_w_size < size )
+		return -1;
 	
 	buffer[ 0 ]	= reg_adr;
 	for ( uint16_t i = 0; i < size; i++)
 		buffer[ i + 1 ]	= data[ i ];
 	
-	return tx( buffer, sizeof( buffer ) );
+	return tx( buffer, size + 1 );
 }
 
 int I2C_device::reg_w( uint8_t reg_adr, uint8_t data )
@@ -77,6 +80,16 @@ uint8_t I2C_device::reg_r( uint8_t reg_adr )
 	return buffer;
 } 
 
+int I2C_device::reg_r_async( uint8_t reg_adr, uint8_t *data, uint16_t size, I2C::async_cb_t callback )
+{
+	return i2c.async_reg_read( i2c_addr, reg_adr, data, size, callback );
+}
+
+int I2C_device::async_pending( void )
+{
+	return i2c.async_pending();
+}
+
 void I2C_device::write_r8( uint8_t reg, uint8_t val )
 {
 	reg_w( reg, val );
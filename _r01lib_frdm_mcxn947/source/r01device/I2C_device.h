@@ -47,6 +47,9 @@ public:
 class I2C_device : public Serial_device
 {
 public:
+	/** Maximum data size of multiple register write, buffer is taken on stack in this size */
+	constexpr static int	max_reg_w_size	= 32;
+
 	/** Create a I2C_device instance with specified address
 	 *
 	 * @param interface I2C instance
@@ -86,8 +89,8 @@ public:
 	 * 
 	 * @param reg register index/address/pointer
 	 * @param data pointer to data buffer
-	 * @param size data size
-	 * @return transferred data size
+	 * @param size data size, up to max_reg_w_size
+	 * @return transferred data size or -1 if the size is larger than max_reg_w_size
 	 */
 	int reg_w( uint8_t reg_adr, const uint8_t *data, uint16_t size );
 
@@ -118,6 +121,22 @@ public:
 	 */
 	uint8_t	reg_r( uint8_t reg_adr );
 
+	/** Multiple register read, non-blocking
+	 * 
+	 *	The request is queued in I2C and the method returns immediately.
+	 *	Register pointer write and data read are joined by repeated-START.
+	 *
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data buffer, must be kept until the callback is called
+	 * @param size data size
+	 * @param callback (option) called with transfer status in interrupt context when the read completed
+	 * @return 0 if queued, or error code if the queue is full or the interface does not support
+	 */
+	int reg_r_async( uint8_t reg_adr, uint8_t *data, uint16_t size, I2C::async_cb_t callback = nullptr );
+
+	/** Number of non-blocking requests not completed on the interface */
+	int async_pending( void );
+
 	/** Register write, 8 bit
 	 *
 	 * @param reg register index/address/pointer
@@ -7,49 +7,201 @@
  */
 
 #include	"AFE_NXP.h"
+#include	"unpack24.h"
 #include	"r01lib.h"
 #include	<math.h>
+#include	<stdlib.h>
 
-using enum	NAFE13388_Base::Register16;
-using enum	NAFE13388_Base::Register24;
+using enum	NAFE_registers::Register16;
+using enum	NAFE_registers::Register24;
 
 /* AFE_base class ******************************************/
 
+AFE_base	*AFE_base::instances[ max_instances ]	= { nullptr };
+
 AFE_base::AFE_base( SPI& spi, int nINT, int DRDY, int SYN, int nRESET ) : 
-	SPI_for_AFE( spi ), enabled_channels( 0 ), pin_nINT( nINT ), pin_DRDY( DRDY ), pin_SYN( SYN, 1 ), pin_nRESET( nRESET, 1 )
+	SPI_for_AFE( spi ), enabled_channels( 0 ), 
+	drdy_time( 0 ), drdy_flag( false ), drdy_enabled( false ), nINT_flag( false ), 
+	pin_nINT( nINT ), pin_DRDY( DRDY ), pin_SYN( SYN, 1 ), pin_nRESET( nRESET, 1 )
 {
+	for ( auto i = 0; i < 16; i++ )
+	{
+		inl_lut[ i ]			= nullptr;
+		conversion_time[ i ]	= 0.0;
+	}
 }
 
 AFE_base::~AFE_base()
 {
+	for ( auto i = 0; i < max_instances; i++ )
+		if ( instances[ i ] == this )
+			instances[ i ]	= nullptr;
+}
+
+template<int N>
+void AFE_base::nINT_isr( void )
+{
+	if ( instances[ N ] )
+		instances[ N ]->nINT_flag	= true;
+}
+
+template<int N>
+void AFE_base::DRDY_isr( void )
+{
+	if ( instances[ N ] )
+	{
+		instances[ N ]->drdy_time	= cycle_counter();
+		instances[ N ]->drdy_flag	= true;
+	}
+}
+
+int AFE_base::instance_index( void )
+{
+	for ( auto i = 0; i < max_instances; i++ )
+		if ( instances[ i ] == this )
+			return i;
+
+	for ( auto i = 0; i < max_instances; i++ )
+	{
+		if ( !instances[ i ] )
+		{
+			instances[ i ]	= this;
+			return i;
+		}
+	}
+
+	panic( "AFE_base: too many instances to use interrupt pins\r\n" );
+	return 0;
+}
+
+void AFE_base::nINT_attach( void )
+{
+	constexpr func_ptr	isr[ max_instances ]	= { nINT_isr<0>, nINT_isr<1>, nINT_isr<2>, nINT_isr<3> };
+
+	pin_nINT.fall( isr[ instance_index() ] );
+}
+
+void AFE_base::drdy_timestamp( bool enable )
+{
+	constexpr func_ptr	isr[ max_instances ]	= { DRDY_isr<0>, DRDY_isr<1>, DRDY_isr<2>, DRDY_isr<3> };
+
+	pin_DRDY.rise( enable ? isr[ instance_index() ] : nullptr );
+
+	drdy_flag		= false;
+	drdy_enabled	= enable;
 }
 
-void AFE_base::begin( void )
+status_t AFE_base::begin( void )
 {
-	reset();
-	boot();	
+	status_t	r;
+
+	begin_start();
+
+	while ( kStatus_Busy == (r = begin_poll()) )
+		;
+
+	return r;
 }
 
-template<> 
-int32_t AFE_base::read( int ch, float delay )
+template<>
+AFE_base::raw_t AFE_base::convert( int ch, raw_t raw )
 {
-	start_and_delay( ch, delay );
-	return adc_read( ch );
-};
+	return inl_lut[ ch ] ? inl_lut[ ch ]->correct( raw ) : raw;
+}
 
 template<>
-double AFE_base::read( int ch, float delay )
+AFE_base::microvolt_t AFE_base::convert( int ch, raw_t raw )
 {
-	return read<int32_t>( ch, delay ) * coeff_uV[ ch ];
-};
+	return convert<raw_t>( ch, raw ) * coeff_uV[ ch ];
+}
 
-void AFE_base::start_and_delay( int ch, float delay )
+template<>
+AFE_base::timestamped_t AFE_base::convert( int ch, raw_t raw )
+{
+	timestamped_t	sample;
+
+	sample.raw			= convert<raw_t>( ch, raw );
+	sample.timestamp	= (drdy_enabled && drdy_flag) ? drdy_time : cycle_counter();
+	
+	return sample;
+}
+
+void AFE_base::correction( int ch, const INL_LUT *lut )
+{
+	inl_lut[ ch ]	= lut;
+}
+
+AFE_base::settled_t AFE_base::read_settled( int ch, int32_t threshold, float timeout, int average )
 {
-	if ( delay >= 0.0 )
+	settled_t		result	= { 0, 0.0, 0, false };
+	const uint32_t	start_time	= cycle_counter();
+	const uint32_t	deadline	= start_time + (uint32_t)(timeout * cycle_frequency());
+	bool			first		= true;
+	raw_t			previous	= 0;
+
+	if ( average < 1 )
+		average	= 1;
+	
+	while ( true )
 	{
-		start( ch );
-		wait( delay );
+		int64_t	sum		= 0;
+		bool	ready	= true;
+
+		for ( auto i = 0; i < average; i++ )
+		{
+			drdy_arm();
+			start( ch );
+
+			if ( !(ready = drdy_wait( deadline )) )
+				break;	//	conversion not completed, the sample is not used
+
+			sum	+= read<raw_t>( ch );
+			result.conversions++;
+		}
+
+		if ( !ready )
+			break;
+
+		result.raw	= (raw_t)(sum / average);
+
+		if ( !first && (abs( result.raw - previous ) <= threshold) )
+		{
+			result.settled	= true;
+			break;
+		}
+
+		if ( 0 <= (int32_t)(cycle_counter() - deadline) )
+			break;
+
+		previous	= result.raw;
+		first		= false;
 	}
+
+	result.time	= (float)(cycle_counter() - start_time) / cycle_frequency();
+
+	return result;
+}
+
+void AFE_base::drdy_arm( void )
+{
+	if ( !drdy_enabled )
+		drdy_timestamp( true );
+
+	drdy_flag	= false;
+}
+
+bool AFE_base::drdy_wait( uint32_t deadline )
+{
+	while ( !drdy_flag )
+		if ( 0 <= (int32_t)(cycle_counter() - deadline) )
+			return false;
+
+	return true;
+}
+
+void AFE_base::start_and_delay( int ch, float delay )
+{
+	start_and_delay( ch, delay, [ this ]( int c ) { start( c ); } );
 }
 
 int AFE_base::bit_count( uint32_t value )
@@ -66,18 +218,123 @@ int AFE_base::bit_count( uint32_t value )
 }
 
 
-/* NAFE13388_Base class ******************************************/
+/* NAFE_Base class ******************************************/
+
+template<class traits>
+NAFE_Base<traits>::NAFE_Base( SPI& spi, int nINT, int DRDY, int SYN, int nRESET ) 
+	: AFE_base( spi, nINT, DRDY, SYN, nRESET ), boot_step( BOOT_IDLE ), boot_retry( 0 ), step_time( 0 )
+{
+	for ( auto ch = 0; ch < traits::logical_channels; ch++ )
+	{
+		ch_cal_slot[ ch ]	= -1;
+		ch_config0[ ch ]	= 0;
+		ch_config1[ ch ]	= 0;
+		ch_config3[ ch ]	= 0;
+	}
+
+	sys_config0	= 0;
+	gpo_data	= 0;
+}
+
+template<class traits>
+NAFE_Base<traits>::~NAFE_Base()
+{
+}
+
+template<class traits>
+void NAFE_Base<traits>::begin_start( bool hardware_reset )
+{
+	if ( hardware_reset )
+	{
+		pin_nRESET	= 0;
+		step_next( BOOT_RESET_PULSE, reset_pulse_width );
+	}
+	else
+	{
+		command( CMD_RESET ); 
+		step_next( BOOT_WAIT_READY, ready_poll_interval );
+	}
+
+	boot_retry	= ready_poll_retry;
+}
+
+template<class traits>
+status_t NAFE_Base<traits>::begin_poll( void )
+{
+	switch ( boot_step )
+	{
+		case BOOT_IDLE:
+			return kStatus_Fail;
+		case BOOT_DONE:
+			return kStatus_Success;
+		case BOOT_TIMEOUT:
+			return kStatus_Timeout;
+		default:
+			break;
+	}
+	
+	if ( !step_due() )
+		return kStatus_Busy;
+	
+	switch ( boot_step )
+	{
+		case BOOT_RESET_PULSE:
+			pin_nRESET	= 1;
+			step_next( BOOT_WAIT_READY, ready_poll_interval );
+			break;
+		case BOOT_WAIT_READY:
+			if ( field<CHIP_READY>() )
+			{
+				boot_io();
+				step_next( BOOT_IO, boot_settle_time );
+			}
+			else if ( --boot_retry )
+			{
+				step_next( BOOT_WAIT_READY, ready_poll_interval );
+			}
+			else
+			{
+				boot_step	= BOOT_TIMEOUT;
+				return kStatus_Timeout;
+			}
+			break;
+		case BOOT_IO:
+			boot_sys();
+			step_next( BOOT_SYS, boot_settle_time );
+			break;
+		case BOOT_SYS:
+			boot_step	= BOOT_DONE;
+			return kStatus_Success;
+	}
+
+	return kStatus_Busy;
+}
+
+template<class traits>
+void NAFE_Base<traits>::step_next( int step, float delay )
+{
+	boot_step	= step;
+	step_time	= cycle_counter() + (uint32_t)(delay * cycle_frequency());
+}
 
-NAFE13388_Base::NAFE13388_Base( SPI& spi, int nINT, int DRDY, int SYN, int nRESET ) 
-	: AFE_base( spi, nINT, DRDY, SYN, nRESET )
+template<class traits>
+bool NAFE_Base<traits>::step_due( void )
 {
+	return 0 <= (int32_t)(cycle_counter() - step_time);
 }
 
-NAFE13388_Base::~NAFE13388_Base()
+template<class traits>
+void NAFE_Base<traits>::boot( void )
 {
+	boot_io();
+	wait( boot_settle_time );
+	
+	boot_sys();
+	wait( boot_settle_time );
 }
 
-void NAFE13388_Base::boot( void )
+template<class traits>
+void NAFE_Base<traits>::boot_io( void )
 {
 	command( CMD_ABORT ); 
 	reg( GPIO_CONFIG0, 0x0000 );
@@ -85,18 +342,24 @@ void NAFE13388_Base::boot( void )
 	reg( GPIO_CONFIG2, 0x0000 );
 	reg( GPO_DATA,     0x0000 );
 	reg( GPI_DATA,     0x0000 );
-	wait( 0.001 );
-	
-	reg( SYS_CONFIG0,  0x0010 );
-	wait( 0.001 );
+
+	gpo_data	= 0x0000;
+}
+
+template<class traits>
+void NAFE_Base<traits>::boot_sys( void )
+{
+	sys_config0	= DRDY_PIN_SEQ::value( 1 );
+	reg( SYS_CONFIG0,  sys_config0 );
 }
 
-void NAFE13388_Base::reset( bool hardware_reset )
+template<class traits>
+status_t NAFE_Base<traits>::reset( bool hardware_reset )
 {
 	if ( hardware_reset )
 	{
 		pin_nRESET	= 0;
-		wait( 0.001 );
+		wait( reset_pulse_width );
 		pin_nRESET	= 1;
 	}
 	else
@@ -104,23 +367,22 @@ void NAFE13388_Base::reset( bool hardware_reset )
 		command( CMD_RESET ); 
 	}
 	
-	constexpr uint16_t	CHIP_READY	= 1 << 13;
-	constexpr auto		RETRY		= 10;
-	
-	for ( auto i = 0; i < RETRY; i++ )
+	for ( auto i = 0; i < ready_poll_retry; i++ )
 	{
-		wait( 0.003 );
-		if ( reg( SYS_STATUS0 ) & CHIP_READY )
-			return;
+		wait( ready_poll_interval );
+		if ( field<CHIP_READY>() )
+		{
+			sys_config0	= reg( SYS_CONFIG0 );	//	reset value
+			return kStatus_Success;
+		}
 	}
 	
-	panic( "NAFE13388 couldn't get ready. Check power supply or pin conections\r\n" );
+	return kStatus_Timeout;
 }
 
-void NAFE13388_Base::logical_ch_config( int ch, uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t cc3 )
+template<class traits>
+void NAFE_Base<traits>::logical_ch_config( int ch, uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t cc3 )
 {	
-	constexpr double	pga_gain[]	= { 0.2, 0.4, 0.8, 1, 2, 4, 8, 16 };
-	
 	command( ch );
 	
 	reg( CH_CONFIG0, cc0 );
@@ -128,77 +390,121 @@ void NAFE13388_Base::logical_ch_config( int ch, uint16_t cc0, uint16_t cc1, uint
 	reg( CH_CONFIG2, cc2 );
 	reg( CH_CONFIG3, cc3 );
 	
+	ch_config3[ ch ]	= cc3;
+	
 	const uint16_t	setbit	= 0x1 << ch;
 	const uint16_t	bits	= bit_op( CH_CONFIG4, ~setbit, setbit );
 	
 	enabled_channels	= bit_count( bits );
-			
-	if ( cc0 & 0x0010 )
-		coeff_uV[ ch ]	= ((10.0 / (double)(1L << 24)) / pga_gain[ (cc0 >> 5) & 0x7 ]) * 1e6;
-	else
-		coeff_uV[ ch ]	= (4.0 / (double)(1L << 24)) * 1e6;
+	ch_cal_slot[ ch ]	= CH_CAL_GAIN_OFFSET::get( cc1 );
+	
+	coeff_update( ch, cc0 );
+	timing_update( ch, cc1, cc2 );
 }
 
-void NAFE13388_Base::logical_ch_config( int ch, const uint16_t (&cc)[ 4 ] )
-{	
-	logical_ch_config( ch, cc[ 0 ], cc[ 1 ], cc[ 2 ], cc[ 3 ] );
-}
+template<class traits>
+void NAFE_Base<traits>::coeff_update( int ch, uint16_t cc0 )
+{
+	constexpr double	fullscale_data	= (double)(1L << traits::adc_resolution);
 
-void NAFE13388_Base::logical_ch_disable( int ch )
-{	
-	const uint16_t	clearingbit	= 0x1 << ch;
-	const uint16_t	bits		= bit_op( CH_CONFIG4, ~clearingbit, ~clearingbit );
+	ch_config0[ ch ]	= cc0;
 
-	enabled_channels	= bit_count( bits );
+	if ( HV_SEL::get( cc0 ) )
+		coeff_uV[ ch ]	= ((2.0 * traits::pga1x_voltage / fullscale_data) / traits::pga_gain[ CH_GAIN::get( cc0 ) ]) * 1e6;
+	else
+		coeff_uV[ ch ]	= (traits::lv_span_voltage / fullscale_data) * 1e6;
 }
 
-int32_t NAFE13388_Base::adc_read( int ch )
+template<class traits>
+void NAFE_Base<traits>::timing_update( int ch, uint16_t cc1, uint16_t cc2 )
 {
-	return reg( CH_DATA0 + ch );
-}
+	//	single conversion needs the SINC filter to settle: (order) output periods after filter reset
+	
+	constexpr int	rates	= sizeof( traits::data_rate ) / sizeof( traits::data_rate[ 0 ] );
+	const int		rate_i	= ADC_DATA_RATE::get( cc1 ) < rates ? ADC_DATA_RATE::get( cc1 ) : rates - 1;
+	const double	settle	= (ADC_SINC::get( cc1 ) + 1) / traits::data_rate[ rate_i ];
+	const double	delay	= CH_DELAY::get( cc2 ) * traits::ch_delay_unit;
 
-void NAFE13388_Base::start( int ch )
-{
-	command( ch     );
-	command( CMD_SS );
+	ch_config1[ ch ]		= cc1;
+	conversion_time[ ch ]	= (settle + delay) * conversion_time_margin;
 }
 
-void NAFE13388_Base::command( uint16_t com )
+template<class traits>
+double NAFE_Base<traits>::data_rate( int ch )
 {
-	write_r16( com );
+	constexpr int	rates	= sizeof( traits::data_rate ) / sizeof( traits::data_rate[ 0 ] );
+	const int		rate_i	= ADC_DATA_RATE::get( ch_config1[ ch ] );
+
+	if ( ch_cal_slot[ ch ] < 0 )
+		return 0.0;
+
+	return traits::data_rate[ rate_i < rates ? rate_i : rates - 1 ];
 }
 
-void NAFE13388_Base::reg( Register16 r, uint16_t value )
-{
-	write_r16( static_cast<uint16_t>( r ), value );
+template<class traits>
+void NAFE_Base<traits>::logical_ch_config( int ch, const uint16_t (&cc)[ 4 ] )
+{	
+	logical_ch_config( ch, cc[ 0 ], cc[ 1 ], cc[ 2 ], cc[ 3 ] );
 }
 
-void NAFE13388_Base::reg( Register24 r, uint32_t value )
+template<class traits>
+bool NAFE_Base<traits>::pga_gain( int ch, int pga_gain_index, int coeff_slot )
 {
-	write_r24( static_cast<uint16_t>( r ), value );
+	if ( (ch_cal_slot[ ch ] < 0) || !HV_SEL::get( ch_config0[ ch ] ) )
+		return false;
+
+	const uint16_t	cc0	= CH_GAIN::set( ch_config0[ ch ], pga_gain_index );
+	const uint16_t	cc1	= CH_CAL_GAIN_OFFSET::set( ch_config1[ ch ], (coeff_slot < 0) ? pga_gain_index : coeff_slot );
+
+	command( ch );
+
+	if ( cc0 != ch_config0[ ch ] )
+		reg( CH_CONFIG0, cc0 );
+
+	if ( cc1 != ch_config1[ ch ] )
+		reg( CH_CONFIG1, cc1 );
+
+	ch_config1[ ch ]	= cc1;
+	ch_cal_slot[ ch ]	= CH_CAL_GAIN_OFFSET::get( cc1 );
+
+	coeff_update( ch, cc0 );
+
+	return true;
 }
 
-uint16_t NAFE13388_Base::reg( Register16 r )
+template<class traits>
+int NAFE_Base<traits>::pga_gain( int ch )
 {
-	return read_r16( static_cast<uint16_t>( r ) );
+	if ( (ch_cal_slot[ ch ] < 0) || !HV_SEL::get( ch_config0[ ch ] ) )
+		return -1;
+
+	return CH_GAIN::get( ch_config0[ ch ] );
 }
 
-uint32_t NAFE13388_Base::reg( Register24 r )
-{
-	return read_r24( static_cast<uint16_t>( r ) );
+template<class traits>
+void NAFE_Base<traits>::logical_ch_disable( int ch )
+{	
+	const uint16_t	clearingbit	= 0x1 << ch;
+	const uint16_t	bits		= bit_op( CH_CONFIG4, ~clearingbit, ~clearingbit );
+
+	enabled_channels	= bit_count( bits );
+	ch_cal_slot[ ch ]	= -1;
 }
 
-uint32_t NAFE13388_Base::part_number( void )
+template<class traits>
+uint32_t NAFE_Base<traits>::part_number( void )
 {
 	return (static_cast<uint32_t>( reg( PN2 ) ) << 16) | reg( PN1 );
 }
 
-uint8_t NAFE13388_Base::revision_number( void )
+template<class traits>
+uint8_t NAFE_Base<traits>::revision_number( void )
 {
 	return reg( PN0 ) & 0xF;
 }
 
-uint64_t NAFE13388_Base::serial_number( void )
+template<class traits>
+uint64_t NAFE_Base<traits>::serial_number( void )
 {
 	uint64_t	serial_number;
 
@@ -207,63 +513,85 @@ uint64_t NAFE13388_Base::serial_number( void )
 	return serial_number | reg( SERIAL0 );
 }
 			
-float NAFE13388_Base::temperature( void )
+template<class traits>
+float NAFE_Base<traits>::temperature( void )
 {
 	return reg( DIE_TEMP ) / 64.0;
 }
 
-void NAFE13388_Base::gain_offset_coeff( const ref_points &ref )
+template<class traits>
+void NAFE_Base<traits>::gain_offset_coeff( const ref_points &ref )
 {
-	constexpr double	pga1x_voltage		= 5.0;
-	constexpr int		adc_resolution		= 24;
-	constexpr double	pga_gain_setting	= 0.2;
-
-	constexpr double	fullscale_voltage	= pga1x_voltage / pga_gain_setting;
-
-	double	fullscale_data		= pow( 2, (adc_resolution - 1) );
 	double	ref_data_span		= ref.high.data		- ref.low.data;
 	double	ref_voltage_span	= ref.high.voltage	- ref.low.voltage;
-	
 	double	dv_slope			= ref_data_span / ref_voltage_span;
-	double	custom_gain			= dv_slope * (fullscale_voltage / fullscale_data);
-	double	custom_offset		= (dv_slope * ref.low.voltage - ref.low.data) / custom_gain;
+
+#if 0
+	printf( "ref_point_high = %8ld @%6.3lf\r\n", ref.high.data, ref.high.voltage );
+	printf( "ref_point_low  = %8ld @%6.3lf\r\n", ref.low.data,  ref.low.voltage  );
+#endif
+	
+	coeff_write( ref.coeff_index, ref.cal_index, dv_slope, ref.low.data - dv_slope * ref.low.voltage );
+}
+
+template<class traits>
+bool NAFE_Base<traits>::gain_offset_coeff( const reference_point *points, int n, int coeff_index, int cal_index, fit_result *result, const float *weights )
+{
+	fit_point	fp[ max_reference_points ];
+	fit_result	r;
+
+	if ( (n < 2) || (max_reference_points < n) )
+		return false;
+
+	for ( auto i = 0; i < n; i++ )
+		fp[ i ]	= { (float)points[ i ].voltage, (float)points[ i ].data, weights ? weights[ i ] : 1.0f };
+
+	if ( !linear_fit( fp, n, r ) )
+		return false;
+
+	if ( result )
+		*result	= r;
+
+	coeff_write( coeff_index, cal_index, r.slope, r.intercept );
+
+	return true;
+}
+
+template<class traits>
+void NAFE_Base<traits>::coeff_write( int coeff_index, int cal_index, double slope, double intercept )
+{
+	constexpr double	pga_gain_setting	= traits::pga_gain[ PGA_GAIN_0_2 ];
+	constexpr double	fullscale_voltage	= traits::pga1x_voltage / pga_gain_setting;
+
+	double	fullscale_data		= pow( 2, (traits::adc_resolution - 1) );
+	double	custom_gain			= slope * (fullscale_voltage / fullscale_data);
+	double	custom_offset		= -intercept / custom_gain;
 	
-	int32_t	gain_coeff_cal		= reg( GAIN_COEFF0   + ref.cal_index );
-	int32_t	offsset_coeff_cal	= reg( OFFSET_COEFF0 + ref.cal_index );
+	int32_t	gain_coeff_cal		= reg( GAIN_COEFF0   + cal_index );
+	int32_t	offsset_coeff_cal	= reg( OFFSET_COEFF0 + cal_index );
 	int32_t	gain_coeff_new		= round( gain_coeff_cal * custom_gain );
 	int32_t	offset_coeff_new	= custom_offset - offsset_coeff_cal;
 
 #if 0
-	printf( "ref_point_high = %8ld @%6.3lf\r\n", ref.high.data, ref.high.voltage );
-	printf( "ref_point_low  = %8ld @%6.3lf\r\n", ref.low.data,  ref.low.voltage  );
 	printf( "gain_coeff_new   = %8ld\r\n", gain_coeff_new   );
 	printf( "offset_coeff_new = %8ld\r\n", offset_coeff_new );
 #endif
 	
-	reg( GAIN_COEFF0   + ref.coeff_index, gain_coeff_new   );
-	reg( OFFSET_COEFF0 + ref.coeff_index, offset_coeff_new );
+	reg( GAIN_COEFF0   + coeff_index, gain_coeff_new   );
+	reg( OFFSET_COEFF0 + coeff_index, offset_coeff_new );
 }
 
-void NAFE13388_Base::recalibrate( int pga_gain_index, bool use_positive_side, int ch_GND, int ch_REF )
+template<class traits>
+bool NAFE_Base<traits>::recalibrate( int pga_gain_index, bool use_positive_side, int ch_GND, int ch_REF, cal_result *result )
 {
-	constexpr	auto	low_gain_index	= 4;
-	uint16_t			reference_source_selection;
-	double				reference_source_voltage;
+	HVInput	reference_source_selection;
+	double	reference_source_voltage;
 
-	if ( pga_gain_index <= low_gain_index )
-	{
-		reference_source_selection	= 0x5;	//	REFH for low gain
-		reference_source_voltage	= 2.30;
-	}
-	else
-	{
-		reference_source_selection	= 0x6;	//	REFL for high gain
-		reference_source_voltage	= 0.20;
-	}
+	cal_reference( pga_gain_index, reference_source_selection, reference_source_voltage );
 
-	const uint16_t	REF_GND		= 0x0010  | (pga_gain_index << 5);
-	const uint16_t	REF_V		= (reference_source_selection << (use_positive_side ? 12 : 8)) | REF_GND;
-	const uint16_t	ch_config1	= (pga_gain_index << 12) | 0x00E4;
+	const uint16_t	REF_GND		= HV_SEL::value( 1 ) | CH_GAIN::value( pga_gain_index );
+	const uint16_t	REF_V		= (use_positive_side ? HV_AIP::value( reference_source_selection ) : HV_AIN::value( reference_source_selection )) | REF_GND;
+	const uint16_t	ch_config1	= CH_CAL_GAIN_OFFSET::value( pga_gain_index ) | ADC_DATA_RATE::value( traits::cal_data_rate ) | ADC_SINC::value( traits::cal_sinc );
 
 	const ch_setting_t	refh	= { REF_V,   ch_config1, 0x2900, 0x0000 };
 	const ch_setting_t	refg	= { REF_GND, ch_config1, 0x2900, 0x0000 };
@@ -271,15 +599,23 @@ void NAFE13388_Base::recalibrate( int pga_gain_index, bool use_positive_side, in
 	logical_ch_config( ch_REF, refh );
 	logical_ch_config( ch_GND, refg );
 	
-	constexpr	auto	delay_to_read_adc	= 1.1;
+	const settled_t	REF	= read_settled( ch_REF, cal_settling_threshold, cal_settling_conversions * cal_conversion_time );
+	const settled_t	GND	= read_settled( ch_GND, cal_settling_threshold, cal_settling_conversions * cal_conversion_time );
+
+	logical_ch_disable( ch_GND );
+	logical_ch_disable( ch_REF );
 
-	raw_t	data_REF	= read<raw_t>( ch_REF, delay_to_read_adc );
-	raw_t	data_GND	= read<raw_t>( ch_GND, delay_to_read_adc );
+	if ( !REF.settled || !GND.settled )
+	{
+		if ( result )
+			*result	= { pga_gain_index, 0, 0, 0.0, 0, 0.0, REF.time + GND.time, false };
 
-	constexpr double	pga_gain[]	= { 0.2, 0.4, 0.8, 1, 2, 4, 8, 16 };
+		return false;
+	}
 
-	const double	fullscale_voltage	= 5.00 / pga_gain[ pga_gain_index ];
-	const double	calibrated_gain		= pow( 2, 23 ) * (reference_source_voltage / fullscale_voltage) / (double)(data_REF - data_GND);
+	const raw_t		data_REF		= REF.raw;
+	const raw_t		data_GND		= GND.raw;
+	const double	calibrated_gain	= cal_gain( pga_gain_index, reference_source_voltage, use_positive_side ? (data_REF - data_GND) : (data_GND - data_REF) );
 
 #if 0	
 	printf( "data_REF = %8ld\r\n", data_REF );
@@ -287,16 +623,515 @@ void NAFE13388_Base::recalibrate( int pga_gain_index, bool use_positive_side, in
 	printf( "gain adjustment = %8lf (%lfdB)\r\n", calibrated_gain, 20 * log10( calibrated_gain ) );
 #endif
 	
+	cal_write( pga_gain_index, calibrated_gain, data_GND, result );
+
+	if ( result )
+		result->time	= REF.time + GND.time;
+
+	return true;
+}
+
+template<class traits>
+bool NAFE_Base<traits>::recalibrate_both_sides( int pga_gain_index, int ch_GND, int ch_REFP, int ch_REFN, polarity_cal_result *result )
+{
+	HVInput	reference_source_selection;
+	double	reference_source_voltage;
+
+	cal_reference( pga_gain_index, reference_source_selection, reference_source_voltage );
+
+	const uint16_t	REF_GND		= HV_SEL::value( 1 ) | CH_GAIN::value( pga_gain_index );
+	const uint16_t	REF_P		= HV_AIP::value( reference_source_selection ) | REF_GND;
+	const uint16_t	REF_N		= HV_AIN::value( reference_source_selection ) | REF_GND;
+	const uint16_t	ch_config1	= CH_CAL_GAIN_OFFSET::value( pga_gain_index ) | ADC_DATA_RATE::value( traits::cal_data_rate ) | ADC_SINC::value( traits::cal_sinc );
+
+	const ch_setting_t	refp	= { REF_P,   ch_config1, 0x2900, 0x0000 };
+	const ch_setting_t	refn	= { REF_N,   ch_config1, 0x2900, 0x0000 };
+	const ch_setting_t	refg	= { REF_GND, ch_config1, 0x2900, 0x0000 };
+
+	const uint16_t	user_channels	= reg( CH_CONFIG4 );
+	const uint16_t	cal_channels	= (0x1 << ch_GND) | (0x1 << ch_REFP) | (0x1 << ch_REFN);
+
+	logical_ch_config( ch_REFP, refp );
+	logical_ch_config( ch_REFN, refn );
+	logical_ch_config( ch_GND,  refg );
+
+	//	only calibration channels are converted in the sequence
+	
+	reg( CH_CONFIG4, cal_channels );
+
+	const uint32_t	start_time	= cycle_counter();
+	raw_t			data[ traits::logical_channels ];
+	const bool		settled		= sequence_settled( cal_channels, data, cal_settling_threshold, cal_settling_conversions );
+	const float		time		= (float)(cycle_counter() - start_time) / cycle_frequency();
+
+	reg( CH_CONFIG4, user_channels & ~cal_channels );
+
+	logical_ch_disable( ch_GND  );
+	logical_ch_disable( ch_REFP );
+	logical_ch_disable( ch_REFN );
+
+	if ( !settled )
+	{
+		if ( result )
+			*result	= { { pga_gain_index, 0, 0, 0.0, 0, 0.0, time, false }, 0.0, 0.0, 0.0, false };
+
+		return false;
+	}
+
+	const double	gain_p	= cal_gain( pga_gain_index, reference_source_voltage, data[ ch_REFP ] - data[ ch_GND  ] );
+	const double	gain_n	= cal_gain( pga_gain_index, reference_source_voltage, data[ ch_GND  ] - data[ ch_REFN ] );
+	const double	gain	= (gain_p + gain_n) / 2.0;
+
+#if 0	
+	printf( "data_REFP = %8ld\r\n", data[ ch_REFP ] );
+	printf( "data_REFN = %8ld\r\n", data[ ch_REFN ] );
+	printf( "data_GND  = %8ld\r\n", data[ ch_GND  ] );
+	printf( "symmetry  = %8lf ppm\r\n", (gain_p - gain_n) / gain * 1e6 );
+#endif
+
+	cal_write( pga_gain_index, gain, data[ ch_GND ], result ? &result->result : nullptr );
+
+	if ( result )
+	{
+		result->gain_positive	= gain_p;
+		result->gain_negative	= gain_n;
+		result->symmetry		= (gain_p - gain_n) / gain * 1e6;
+		result->settled			= true;
+		result->result.time		= time;
+	}
+
+	return true;
+}
+
+template<class traits>
+void NAFE_Base<traits>::cal_reference( int pga_gain_index, HVInput &source, double &voltage )
+{
+	if ( pga_gain_index <= traits::low_gain_index )
+	{
+		source	= HV_REFH;	//	REFH for low gain
+		voltage	= traits::refh_voltage;
+	}
+	else
+	{
+		source	= HV_REFL;	//	REFL for high gain
+		voltage	= traits::refl_voltage;
+	}
+}
+
+template<class traits>
+double NAFE_Base<traits>::cal_gain( int pga_gain_index, double reference_voltage, raw_t span )
+{
+	const double	fullscale_voltage	= traits::pga1x_voltage / traits::pga_gain[ pga_gain_index ];
+
+	return pow( 2, traits::adc_resolution - 1 ) * (reference_voltage / fullscale_voltage) / (double)span;
+}
+
+template<class traits>
+void NAFE_Base<traits>::cal_write( int pga_gain_index, double calibrated_gain, raw_t data_GND, cal_result *result )
+{
 	const double	current_gain_coeff_value	= (double)reg( GAIN_COEFF0 + pga_gain_index );
 	const uint32_t	current_offset_coeff_value	= reg( OFFSET_COEFF0 + pga_gain_index );
 
-	reg( GAIN_COEFF0   + pga_gain_index, (uint32_t)(current_gain_coeff_value * calibrated_gain) );
-	reg( OFFSET_COEFF0 + pga_gain_index, current_offset_coeff_value + data_GND );
+	const uint32_t	new_gain_coeff_value		= (uint32_t)(current_gain_coeff_value * calibrated_gain);
+	const uint32_t	new_offset_coeff_value		= current_offset_coeff_value + data_GND;
 
-	logical_ch_disable( ch_GND );
-	logical_ch_disable( ch_REF );
+	reg( GAIN_COEFF0   + pga_gain_index, new_gain_coeff_value   );
+	reg( OFFSET_COEFF0 + pga_gain_index, new_offset_coeff_value );
+
+	if ( result )
+	{
+		result->gain_index		= pga_gain_index;
+		result->gain_coeff		= new_gain_coeff_value;
+		result->offset_coeff	= (int32_t)(new_offset_coeff_value << 8) >> 8;
+		result->gain_factor		= new_gain_coeff_value / current_gain_coeff_value;
+		result->offset_delta	= data_GND;
+		result->temperature		= temperature();
+		result->settled			= true;
+	}
+}
+
+template<class traits>
+bool NAFE_Base<traits>::sequence_read( uint16_t channels, raw_t *data, float timeout )
+{
+	const uint32_t	deadline	= cycle_counter() + (uint32_t)(timeout * cycle_frequency());
+
+	//	DRDY need to come at end of the sequence, not at first channel
+
+	const bool	per_channel	= !DRDY_PIN_SEQ::get( sys_config0 );
+
+	if ( per_channel )
+		reg( SYS_CONFIG0, DRDY_PIN_SEQ::set( sys_config0, 1 ) );
+
+	drdy_arm();
+	command( CMD_MS );
+
+	const bool	ready	= drdy_wait( deadline );
+
+	if ( per_channel )
+		reg( SYS_CONFIG0, sys_config0 );
+
+	for ( auto ch = 0; ch < traits::logical_channels; ch++ )
+		if ( channels & (0x1 << ch) )
+			data[ ch ]	= convert<raw_t>( ch, NAFE_Base::adc_read( ch ) );
+
+	return ready;
+}
+
+template<class traits>
+int NAFE_Base<traits>::burst_read( uint16_t channels, raw_t *data )
+{
+	constexpr uint16_t	com		= static_cast<uint16_t>( CMD_BURST_DATA ) << 1;
+	uint8_t				v[ 2 + 3 * traits::logical_channels ];
+	raw_t				r[ traits::logical_channels ];
+	const int			n		= bit_count( channels );
+
+	v[ 0 ]	= (uint8_t)(com >> 8);
+	v[ 1 ]	= (uint8_t)(com & 0xFF);
+
+	for ( auto i = 2; i < 2 + 3 * n; i++ )
+		v[ i ]	= 0xFF;
+
+	txrx( v, 2 + 3 * n );
+	unpack24( v + 2, r, n );
+
+	for ( int ch = 0, i = 0; ch < traits::logical_channels; ch++ )
+		if ( channels & (0x1 << ch) )
+			data[ ch ]	= convert<raw_t>( ch, r[ i++ ] );
+
+	return n;
+}
+
+/** Pack a command or register address frame into burst buffer */
+static inline int frame( uint8_t *p, uint16_t word )
+{
+	word	<<= 1;
+
+	p[ 0 ]	= (uint8_t)(word >> 8);
+	p[ 1 ]	= (uint8_t)(word & 0xFF);
+
+	return 2;
+}
+
+/** Pack a 16 bit register write frame into burst buffer */
+static inline int frame( uint8_t *p, uint16_t reg, uint16_t value )
+{
+	frame( p, reg );
+
+	p[ 2 ]	= (uint8_t)(value >> 8);
+	p[ 3 ]	= (uint8_t)(value & 0xFF);
+
+	return 4;
+}
+
+template<class traits>
+void NAFE_Base<traits>::start( int ch, const io_setting &io )
+{
+	uint8_t		burst[ 12 ];
+	uint8_t		lengths[ 4 ];
+	int			size	= 0;
+	int			n		= 0;
+
+	const uint16_t	gpo_value	= (gpo_data & ~io.gpo_mask) | (io.gpo_data & io.gpo_mask);
+
+	if ( gpo_value != gpo_data )
+	{
+		lengths[ n ]	 = frame( burst + size, static_cast<uint16_t>( GPO_DATA ), gpo_value );
+		size			+= lengths[ n++ ];
+		gpo_data		 = gpo_value;
+	}
+
+	lengths[ n ]	 = frame( burst + size, ch );
+	size			+= lengths[ n++ ];
+
+	if ( (0 <= io.ch_config3) && ((uint16_t)io.ch_config3 != ch_config3[ ch ]) )
+	{
+		lengths[ n ]		 = frame( burst + size, static_cast<uint16_t>( CH_CONFIG3 ), io.ch_config3 );
+		size				+= lengths[ n++ ];
+		ch_config3[ ch ]	 = io.ch_config3;
+	}
+
+	if ( 0.0 < io.settle )
+	{
+		txrx_frames( burst, lengths, n );
+		wait( io.settle );
+
+		size	= 0;
+		n		= 0;
+	}
+
+	lengths[ n ]	 = frame( burst + size, CMD_SS );
+	size			+= lengths[ n++ ];
+
+	txrx_frames( burst, lengths, n );
+}
+
+template<class traits>
+bool NAFE_Base<traits>::io_read( int ch, const io_setting &io, raw_t &data, float timeout )
+{
+	drdy_arm();
+	start( ch, io );
+
+	const uint32_t	deadline	= cycle_counter() + (uint32_t)(timeout * cycle_frequency());
+	const bool		ready		= drdy_wait( deadline );
+
+	data	= convert<raw_t>( ch, NAFE_Base::adc_read( ch ) );
+
+	return ready;
+}
+
+template<class traits>
+void NAFE_Base<traits>::gpo( uint16_t mask, uint16_t value )
+{
+	const uint16_t	v	= (gpo_data & ~mask) | (value & mask);
+
+	if ( v == gpo_data )
+		return;
+
+	reg( GPO_DATA, v );
+	gpo_data	= v;
+}
+
+template<class traits>
+bool NAFE_Base<traits>::sequence_settled( uint16_t channels, raw_t *data, int32_t threshold, int max_passes )
+{
+	//	a pass converts all channels enabled in CH_CONFIG4, give twice of the estimated time to DRDY
+
+	const float	pass_timeout	= 2.0 * bit_count( reg( CH_CONFIG4 ) ) * cal_conversion_time;
+	raw_t		previous[ traits::logical_channels ];
+
+	for ( auto pass = 0; pass < max_passes; pass++ )
+	{
+		bool	settled	= (0 < pass);
+
+		if ( !sequence_read( channels, data, pass_timeout ) )
+			return false;	//	sequence not completed, the readouts are not used
+
+		for ( auto ch = 0; ch < traits::logical_channels; ch++ )
+		{
+			if ( !(channels & (0x1 << ch)) )
+				continue;
+
+			if ( !pass || (threshold < abs( data[ ch ] - previous[ ch ] )) )
+				settled	= false;
+
+			previous[ ch ]	= data[ ch ];
+		}
+
+		if ( settled )
+			return true;
+	}
+
+	return false;
+}
+
+
+
+template<class traits>
+void NAFE_Base<traits>::snapshot( device_state &state )
+{
+	memset( &state, 0, sizeof( device_state ) );
+
+	state.ch_config4	= reg( CH_CONFIG4 );
+
+	for ( auto ch = 0; ch < traits::logical_channels; ch++ )
+	{
+		if ( !(state.ch_config4 & (0x1 << ch)) )
+			continue;
+
+		command( ch );
+
+		for ( auto i = 0; i < 4; i++ )
+			state.ch_config[ ch ][ i ]	= reg( CH_CONFIG0 + i );
+
+		state.ch_config5[ ch ]	= reg( CH_CONFIG5_0 + ch );
+		state.ch_config6[ ch ]	= reg( CH_CONFIG6_0 + ch );
+	}
+
+	for ( auto i = 0; i < traits::coeff_slots; i++ )
+	{
+		state.gain_coeff[ i ]	= reg( GAIN_COEFF0   + i ) & 0xFFFFFF;
+		state.offset_coeff[ i ]	= reg( OFFSET_COEFF0 + i ) & 0xFFFFFF;
+	}
+
+	state.sys_config0			= reg( SYS_CONFIG0 );
+	state.gpio_config[ 0 ]		= reg( GPIO_CONFIG0 );
+	state.gpio_config[ 1 ]		= reg( GPIO_CONFIG1 );
+	state.gpio_config[ 2 ]		= reg( GPIO_CONFIG2 );
+	state.gpo_data				= reg( GPO_DATA );
+	state.global_alarm_enable	= reg( GLOBAL_ALARM_ENABLE );
+	state.thrs_temp				= reg( THRS_TEMP );
+}
+
+template<class traits>
+void NAFE_Base<traits>::restore( const device_state &state )
+{
+	command( CMD_ABORT );
+
+	reg( SYS_CONFIG0,         state.sys_config0 );
+	reg( GPIO_CONFIG0,        state.gpio_config[ 0 ] );
+	reg( GPIO_CONFIG1,        state.gpio_config[ 1 ] );
+	reg( GPIO_CONFIG2,        state.gpio_config[ 2 ] );
+	reg( GPO_DATA,            state.gpo_data );
+	reg( THRS_TEMP,           state.thrs_temp );
+
+	for ( auto i = 0; i < traits::coeff_slots; i++ )
+	{
+		reg( GAIN_COEFF0   + i, state.gain_coeff[ i ]   );
+		reg( OFFSET_COEFF0 + i, state.offset_coeff[ i ] );
+	}
+
+	for ( auto ch = 0; ch < traits::logical_channels; ch++ )
+	{
+		if ( !(state.ch_config4 & (0x1 << ch)) )
+		{
+			ch_cal_slot[ ch ]	= -1;
+			continue;
+		}
+
+		command( ch );
+
+		for ( auto i = 0; i < 4; i++ )
+			reg( CH_CONFIG0 + i, state.ch_config[ ch ][ i ] );
+
+		reg( CH_CONFIG5_0 + ch, state.ch_config5[ ch ] );
+		reg( CH_CONFIG6_0 + ch, state.ch_config6[ ch ] );
+
+		ch_cal_slot[ ch ]	= CH_CAL_GAIN_OFFSET::get( state.ch_config[ ch ][ 1 ] );
+		ch_config3[ ch ]	= state.ch_config[ ch ][ 3 ];
+		coeff_update( ch, state.ch_config[ ch ][ 0 ] );
+		timing_update( ch, state.ch_config[ ch ][ 1 ], state.ch_config[ ch ][ 2 ] );
+	}
+
+	reg( CH_CONFIG4,          state.ch_config4 );
+	reg( GLOBAL_ALARM_ENABLE, state.global_alarm_enable );
+
+	enabled_channels	= bit_count( state.ch_config4 );
+	sys_config0			= state.sys_config0;
+	gpo_data			= state.gpo_data;
+}
+
+template<class traits>
+void NAFE_Base<traits>::coeff_save( coeff_set &set, uint16_t slots )
+{
+	set.slots	= slots;
+
+	for ( auto i = 0; i < traits::coeff_slots; i++ )
+	{
+		if ( slots & (0x1 << i) )
+		{
+			set.gain[ i ]	= reg( GAIN_COEFF0   + i );
+			set.offset[ i ]	= reg( OFFSET_COEFF0 + i );
+		}
+		else
+		{
+			set.gain[ i ]	= 0;
+			set.offset[ i ]	= 0;
+		}
+	}
+}
+
+template<class traits>
+void NAFE_Base<traits>::coeff_load( const coeff_set &set )
+{
+	for ( auto i = 0; i < traits::coeff_slots; i++ )
+	{
+		if ( !(set.slots & (0x1 << i)) )
+			continue;
+
+		reg( GAIN_COEFF0   + i, set.gain[ i ]   );
+		reg( OFFSET_COEFF0 + i, set.offset[ i ] );
+	}
+}
+
+template<class traits>
+int NAFE_Base<traits>::cal_slot( int ch )
+{
+	return ch_cal_slot[ ch ];
+}
+
+template<class traits>
+uint16_t NAFE_Base<traits>::slot_users( uint16_t slots )
+{
+	uint16_t	users	= 0;
+
+	for ( auto ch = 0; ch < traits::logical_channels; ch++ )
+		if ( (0 <= ch_cal_slot[ ch ]) && (slots & (0x1 << ch_cal_slot[ ch ])) )
+			users	|= 0x1 << ch;
+
+	return users;
+}
+
+template<class traits>
+void NAFE_Base<traits>::alarm_enable( uint16_t mask )
+{
+	nINT_flag	= false;
+	nINT_attach();
+
+	command( CMD_CLEAR_ALARM );
+	reg( GLOBAL_ALARM_ENABLE, mask );
+}
+
+template<class traits>
+void NAFE_Base<traits>::alarm_disable( void )
+{
+	reg( GLOBAL_ALARM_ENABLE, 0x0000 );
+	command( CMD_CLEAR_ALARM );
+
+	nINT_flag	= false;
+}
+
+template<class traits>
+void NAFE_Base<traits>::threshold( int ch, int32_t high, int32_t low )
+{
+	reg( CH_CONFIG5_0 + ch, (uint32_t)high & 0xFFFFFF );
+	reg( CH_CONFIG6_0 + ch, (uint32_t)low  & 0xFFFFFF );
+}
+
+template<class traits>
+int NAFE_Base<traits>::alarm_service( void )
+{
+	if ( !nINT_flag )
+		return 0;
+
+	nINT_flag	= false;
+
+	const int		n_events	= events.size();
+	const uint16_t	alarm		= reg( GLOBAL_ALARM_INTERRUPT );
+	const uint16_t	over		= reg( CH_STATUS0 );
+	const uint16_t	under		= reg( CH_STATUS1 );
+
+	for ( auto ch = 0; ch < traits::logical_channels; ch++ )
+	{
+		if ( over  & (0x1 << ch) )
+			event_put( EventType::CH_OVER_THRESHOLD,  ch, over  );
+		if ( under & (0x1 << ch) )
+			event_put( EventType::CH_UNDER_THRESHOLD, ch, under );
+	}
+
+	if ( alarm & ALARM_TEMP )
+		event_put( EventType::OVER_TEMPERATURE, -1, reg( DIE_TEMP ) );
+
+	if ( alarm & ~ALARM_TEMP )
+		event_put( EventType::GLOBAL_ALARM, -1, alarm & ~ALARM_TEMP );
+
+	command( CMD_CLEAR_ALARM );
+
+	return events.size() - n_events;
+}
+
+template<class traits>
+bool NAFE_Base<traits>::event_get( event &e )
+{
+	return events.get( e );
+}
+
+template<class traits>
+void NAFE_Base<traits>::event_put( EventType type, int ch, uint16_t value )
+{
+	events.put( { type, ch, value } );
 }
 
+template class NAFE_Base<NAFE13388_traits>;
 
 
 /* NAFE13388 class ******************************************/
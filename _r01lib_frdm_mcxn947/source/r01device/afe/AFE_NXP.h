@@ -45,6 +45,9 @@
 #include	<stdint.h>
 #include	"r01lib.h"
 #include	"SPI_for_AFE.h"
+#include	"bit_field.h"
+#include	"linear_fit.h"
+#include	"INL_LUT.h"
 
 class AFE_base : public SPI_for_AFE
 {
@@ -54,6 +57,25 @@ public:
 	using raw_t			= int32_t;
 	using microvolt_t	= double;
 	constexpr static float immidiate_read	= -1.0;
+	constexpr static float auto_delay		= -2.0;
+
+	/** ADC readout with timestamp
+	 *
+	 *	timestamp is a cycle_counter() value captured at DRDY if drdy_timestamp() is enabled. 
+	 *	Otherwise it is captured at the ADC read-out. 
+	 */
+	typedef struct	_timestamped_t	{
+		raw_t		raw;
+		uint32_t	timestamp;
+	} timestamped_t;
+
+	/** Result of read_settled() */
+	typedef struct	_settled_t	{
+		raw_t	raw;			//	average of last conversions
+		float	time;			//	time taken in seconds
+		int		conversions;	//	number of conversions done
+		bool	settled;		//	false if timed-out before settling
+	} settled_t;
 
 	/** Constructor to create a AFE_base instance */
 	AFE_base( SPI& spi, int nINT, int DRDY, int SYN, int nRESET );
@@ -66,16 +88,52 @@ public:
 	 *	NAFE13388 initialization. It does following steps
 	 *	(1) Set pins 2 and 3 are input for nINT and nDRDY
 	 *	(2) Set pins 5 and 6 are output and fixed to HIGH for ADC_SYN and ADC_nRESET
-	 *	(3) Call reset()
-	 *	(4) Call boot()
+	 *	(3) Reset the device and wait it gets ready
+	 *	(4) Set system-level config registers
+	 *
+	 *	This is a blocking call of begin_start() and begin_poll()
+	 *
+	 * @return kStatus_Success or kStatus_Timeout if the device didn't get ready
+	 */
+	virtual status_t begin( void );
+
+	/** Start non-blocking initialization
+	 *
+	 *	Initialization progresses in begin_poll() calls. 
+	 *	Call this again to retry after timeout.
+	 *
+	 *	Example: bringing up 2 AFEs in parallel
+	 *  @code
+	 *	afe0.begin_start();
+	 *	afe1.begin_start();
+	 *	
+	 *	status_t	r0, r1;
+	 *	do {
+	 *		r0	= afe0.begin_poll();
+	 *		r1	= afe1.begin_poll();
+	 *	} while ( (kStatus_Busy == r0) || (kStatus_Busy == r1) );
+	 *  @endcode
+	 *
+	 * @param hardware_reset use nRESET pin instead of RESET command
 	 */
-	virtual void begin( void );
+	virtual void begin_start( bool hardware_reset = false )	= 0;
+
+	/** Progress non-blocking initialization
+	 *
+	 *	This method returns immediately. Call it repeatedly until it returns other than kStatus_Busy
+	 *
+	 * @return kStatus_Busy while in progress, kStatus_Success when done, kStatus_Timeout when the device didn't get ready
+	 */
+	virtual status_t begin_poll( void )	= 0;
 
 	/** Set system-level config registers */
 	virtual void boot( void )	= 0;
 
-	/** Issue RESET command */
-	virtual void reset( bool hardware_reset = false )	= 0;
+	/** Issue RESET command
+	 *
+	 * @return kStatus_Success or kStatus_Timeout if the device didn't get ready
+	 */
+	virtual status_t reset( bool hardware_reset = false )	= 0;
 	
 	/** Configure logical channel
 	 *
@@ -111,6 +169,7 @@ public:
 	 *	If the delay is not given, just the ADC register is read.
 	 *	If the delay is given, measurement is started in this method and read-out after delay.
 	 *	The delay between start and read-out is specified in seconds. 
+	 *	With auto_delay, conversion_time[ ch ] is used as the delay. 
 	 *	
 	 *	This method need to be called with return type as 
 	 *	    double value = read<NAFE13388::microvolt_t>( 0, 0.01 );
@@ -121,7 +180,47 @@ public:
 	 * @return ADC readout value
 	 */
 	template<class T>
-	T read( int ch, float delay = immidiate_read );
+	T read( int ch, float delay = immidiate_read )
+	{
+		start_and_delay( ch, delay );
+		return convert<T>( ch, adc_read( ch ) );
+	}
+
+	/** DRDY timestamp capture
+	 *
+	 *	Captures cycle_counter() on DRDY pin rising edge to timestamp the samples
+	 *	
+	 * @param enable true for capturing
+	 */
+	void	drdy_timestamp( bool enable = true );
+
+	/** Read ADC with settling detection
+	 *
+	 *	Repeats conversions and takes averages of "average" conversions. 
+	 *	The reading is settled when the change between two successive averages is within threshold. 
+	 *	Each conversion is read-out at DRDY, not after a fixed delay. 
+	 *	A conversion which didn't complete in timeout is not used, the result is not settled in that case. 
+	 *	Give timeout of at least two conversion_time[ ch ] * average. 
+	 *	DRDY capture is enabled by this method if it was not. 
+	 *	
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param threshold settling threshold in ADC counts
+	 * @param timeout maximum time in seconds
+	 * @param average number of conversions for an average
+	 * @return settled_t: value, time taken and status
+	 */
+	settled_t	read_settled( int ch, int32_t threshold, float timeout, int average = 1 );
+
+	/** Nonlinearity correction
+	 *
+	 *	Set a lookup table to correct ADC readouts of the logical channel. 
+	 *	The correction is applied in read() for all return types. 
+	 *	The table is not copied, it need to be kept while in use. 
+	 *	
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param lut pointer to INL_LUT instance. nullptr to disable the correction
+	 */
+	void	correction( int ch, const INL_LUT *lut );
 
 	/** Start ADC
 	 *
@@ -135,84 +234,102 @@ public:
 	/** Coefficient to convert from ADC read value to micro-volt */
 	double	coeff_uV[ 16 ];
 
-private:
-	void	start_and_delay( int ch, float delay );
+	/** Single conversion time in seconds, estimated from logical channel settings */
+	float	conversion_time[ 16 ];
 
-protected:
-	int 	bit_count( uint32_t value );
-
-	DigitalIn	pin_nINT;
-	DigitalIn	pin_DRDY;
-	DigitalOut	pin_SYN;
-	DigitalOut	pin_nRESET;
-};
+private:
+	const INL_LUT	*inl_lut[ 16 ];
 
-class NAFE13388_Base : public AFE_base
-{
-public:
-	
-	/** Constructor to create a AFE_base instance */
-	NAFE13388_Base( SPI& spi, int nINT, int DRDY, int SYN, int nRESET );
+	constexpr static int	max_instances	= 4;
+	static AFE_base			*instances[ max_instances ];
 
-	/** Destractor */
-	virtual ~NAFE13388_Base();
-	
+	int		instance_index( void );
 
-	using	ch_setting_t	= const uint16_t[ 4 ];
+	template<int N>
+	static void	nINT_isr( void );
 
-	typedef struct	_reference_point	{
-		double	voltage;
-		int32_t	data;
-	} reference_point;
+	template<int N>
+	static void	DRDY_isr( void );
 
-	typedef struct	_ref_points	{
-		int				coeff_index;
-		reference_point	high;
-		reference_point	low;
-		int				cal_index;
-	} ref_points;
+protected:
+	int 	bit_count( uint32_t value );
 
-	/** Set system-level config registers */
-	virtual void boot( void );
+	/** Start measurement and wait before read-out, for read() */
+	void	start_and_delay( int ch, float delay );
 
-	/** Issue RESET command */
-	virtual void reset( bool hardware_reset = false );
-	
-	/** Configure logical channel
+	/** Start measurement and wait before read-out
 	 *
+	 *	Common part of read() of all classes. 
+	 *	The conversion is started by start_f, so a derived class can give statically bound start(). 
+	 *	
 	 * @param ch logical channel number (0 ~ 15)
-	 * @param cc0	16bit value to be set CH_CONFIG0 register (0x20)
-	 * @param cc1	16bit value to be set CH_CONFIG1 register (0x21)
-	 * @param cc2	16bit value to be set CH_CONFIG2 register (0x22)
-	 * @param cc3	16bit value to be set CH_CONFIG3 register (0x23)
+	 * @param delay read-out delay in seconds, auto_delay or immidiate_read
+	 * @param start_f callable to start the conversion: start_f( ch )
 	 */
-	virtual void logical_ch_config( int ch, uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t cc3 );
+	template<class F>
+	void	start_and_delay( int ch, float delay, F start_f )
+	{
+		if ( delay == auto_delay )
+			delay	= conversion_time[ ch ];
 
-	/** Configure logical channel
+		if ( delay >= 0.0 )
+		{
+			drdy_flag	= false;
+			start_f( ch );
+			wait( delay );
+		}
+	}
+
+	/** Convert ADC readout
 	 *
-	 * @param ch logical channel number (0 ~ 15)
-	 * @param cc array for CH_CONFIG0, CH_CONFIG1, CH_CONFIG2 and CH_CONFIG3 values
+	 *	Applies nonlinearity correction and unit conversion for read() return type. 
+	 *	Specialized for raw_t, microvolt_t and timestamped_t. 
 	 */
-	virtual void logical_ch_config( int ch, const uint16_t (&cc)[ 4 ] );
+	template<class T>
+	T		convert( int ch, raw_t raw );
 
-	/** Logical channel disable
-	 *
-	 * @param ch logical channel number (0 ~ 15)
+	volatile uint32_t	drdy_time;
+	volatile bool		drdy_flag;
+	bool				drdy_enabled;
+
+	/** Hook nINT pin falling edge
+	 *	
+	 *	After this call, nINT assertion sets nINT_flag
 	 */
-	virtual void logical_ch_disable( int ch );
+	void	nINT_attach( void );
 
-	/** ADC channel read
-	 *
-	 * @param ch logical channel number (0 ~ 15)
+	/** Prepare to wait DRDY
+	 *	
+	 *	Enables DRDY capture if it is not and clears the flag. Call this before starting conversion
 	 */
-	virtual int32_t	adc_read( int ch );
+	void	drdy_arm( void );
 
-	/** Start ADC
-	 *
-	 * @param ch logical channel number (0 ~ 15)
+	/** Wait DRDY
+	 *	
+	 * @param deadline cycle_counter() value to give up
+	 * @return false if timed-out
 	 */
-	virtual void start( int ch );
+	bool	drdy_wait( uint32_t deadline );
+	
+	/** Set by nINT ISR, cleared by the alarm handling routine */
+	volatile bool	nINT_flag;
+
+	InterruptIn	pin_nINT;
+	InterruptIn	pin_DRDY;
+	DigitalOut	pin_SYN;
+	DigitalOut	pin_nRESET;
+};
 
+template<>	AFE_base::raw_t			AFE_base::convert( int ch, raw_t raw );
+template<>	AFE_base::microvolt_t	AFE_base::convert( int ch, raw_t raw );
+template<>	AFE_base::timestamped_t	AFE_base::convert( int ch, raw_t raw );
+
+/** NAFE register map
+ *
+ *	Registers, commands and bit fields which are common in NAFE family. 
+ */
+struct NAFE_registers
+{
 	enum class Register16 : uint16_t {
 		CH_CONFIG0				= 0x20,
 		CH_CONFIG1				= 0x21,
@@ -389,25 +506,421 @@ public:
 		return T( n + static_cast<uint16_t>( rn ) );
 	}
 
+	/** Register bit field descriptors */
+
+	//	CH_CONFIG0
+	using HV_AIP				= bit_field<Register16, Register16::CH_CONFIG0, 12, 4>;
+	using HV_AIN				= bit_field<Register16, Register16::CH_CONFIG0,  8, 4>;
+	using CH_GAIN				= bit_field<Register16, Register16::CH_CONFIG0,  5, 3>;
+	using HV_SEL				= bit_field<Register16, Register16::CH_CONFIG0,  4, 1>;
+	using LVSIG_IN				= bit_field<Register16, Register16::CH_CONFIG0,  1, 3>;
+	using TCC_OFF				= bit_field<Register16, Register16::CH_CONFIG0,  0, 1>;
+
+	//	CH_CONFIG1
+	using CH_CAL_GAIN_OFFSET	= bit_field<Register16, Register16::CH_CONFIG1, 12, 4>;
+	using CH_THRS				= bit_field<Register16, Register16::CH_CONFIG1,  8, 4>;
+	using ADC_DATA_RATE			= bit_field<Register16, Register16::CH_CONFIG1,  3, 5>;
+	using ADC_SINC				= bit_field<Register16, Register16::CH_CONFIG1,  0, 3>;
+
+	//	CH_CONFIG2
+	using CH_DELAY				= bit_field<Register16, Register16::CH_CONFIG2, 10, 6>;
+	using ADC_NORMAL_SETTLING	= bit_field<Register16, Register16::CH_CONFIG2,  9, 1>;
+	using ADC_FILTER_RESET		= bit_field<Register16, Register16::CH_CONFIG2,  8, 1>;
+	using CH_CHOP				= bit_field<Register16, Register16::CH_CONFIG2,  7, 1>;
+
+	//	CH_CONFIG4
+	using CH_ENABLE				= bit_field<Register16, Register16::CH_CONFIG4,  0, 16>;
+
+	//	SYS_CONFIG0
+	using DRDY_PIN_SEQ			= bit_field<Register16, Register16::SYS_CONFIG0,  4, 1>;	//	1: DRDY at end of multi-channel sequence, 0: at each channel
+
+	//	SYS_STATUS0
+	using CHIP_READY			= bit_field<Register16, Register16::SYS_STATUS0, 13, 1>;
+
+	/** Field values for HV_AIP and HV_AIN */
+	enum HVInput : uint16_t {
+		HV_GND		= 0x0,
+		HV_AI1		= 0x1,
+		HV_AI2		= 0x2,
+		HV_AI3		= 0x3,
+		HV_AI4		= 0x4,
+		HV_REFH		= 0x5,
+		HV_REFL		= 0x6,
+	};
+
+	/** Field values for CH_GAIN */
+	enum PGAGain : uint16_t {
+		PGA_GAIN_0_2	= 0x0,
+		PGA_GAIN_0_4	= 0x1,
+		PGA_GAIN_0_8	= 0x2,
+		PGA_GAIN_1		= 0x3,
+		PGA_GAIN_2		= 0x4,
+		PGA_GAIN_4		= 0x5,
+		PGA_GAIN_8		= 0x6,
+		PGA_GAIN_16		= 0x7,
+	};
+
+	template<Register16 r>
+	using reg16_image	= reg_image<Register16, r, uint16_t>;
+
+	template<Register24 r>
+	using reg24_image	= reg_image<Register24, r, uint32_t>;
+};
+
+/** NAFE13388 device traits
+ *
+ *	Device dependent constants for NAFE_Base. 
+ *	Another NAFE variant can be supported by giving its own traits. 
+ */
+struct NAFE13388_traits
+{
+	constexpr static int	logical_channels	= 16;
+	constexpr static int	coeff_slots			= 16;
+	constexpr static int	adc_resolution		= 24;
+
+	/** Fullscale voltage with PGA gain 1x */
+	constexpr static double	pga1x_voltage		= 5.0;
+
+	/** Span of LV input */
+	constexpr static double	lv_span_voltage		= 4.0;
+
+	/** PGA gain for CH_GAIN field value */
+	constexpr static double	pga_gain[]			= { 0.2, 0.4, 0.8, 1, 2, 4, 8, 16 };
+
+	/** Calibration reference: REFH for gain index up to low_gain_index, REFL for higher */
+	constexpr static int	low_gain_index		= 4;
+	constexpr static double	refh_voltage		= 2.30;
+	constexpr static double	refl_voltage		= 0.20;
+
+	/** ADC setting for calibration readings: ADC_DATA_RATE 21 (60 SPS) and SINC4 */
+	constexpr static int	cal_data_rate		= 21;
+	constexpr static int	cal_sinc			= 4;
+
+	/** CH_DELAY step in seconds (approximate) */
+	constexpr static double	ch_delay_unit		= 32e-6;
+
+	/** Data rate [SPS] for ADC_DATA_RATE field value */
+	constexpr static double	data_rate[]			= {
+		288000, 192000, 144000, 96000, 72000, 48000, 36000, 24000, 
+		 18000,  12000,   9000,  6000,  4500,  3000,  2250,  1125, 
+		 562.5,    400,    300,   200,   100,    60,    50,    30, 
+		    25,     20,     15,    10,   7.5, 
+	};
+};
+
+/** NAFE_Base class
+ *
+ * @tparam traits device traits like NAFE13388_traits
+ */
+template<class traits>
+class NAFE_Base : public AFE_base, public NAFE_registers
+{
+public:
+	
+	/** Device traits */
+	using device	= traits;
+
+	static_assert( traits::logical_channels <= 16, "AFE_base supports up to 16 logical channels" );
+
+	/** Constructor to create a AFE_base instance */
+	NAFE_Base( SPI& spi, int nINT, int DRDY, int SYN, int nRESET );
+
+	/** Destractor */
+	virtual ~NAFE_Base();
+	
+
+	using	ch_setting_t	= const uint16_t[ 4 ];
+
+	typedef struct	_reference_point	{
+		double	voltage;
+		int32_t	data;
+	} reference_point;
+
+	typedef struct	_ref_points	{
+		int				coeff_index;
+		reference_point	high;
+		reference_point	low;
+		int				cal_index;
+	} ref_points;
+
+	/** Start non-blocking initialization
+	 *
+	 * @param hardware_reset use nRESET pin instead of RESET command
+	 */
+	virtual void begin_start( bool hardware_reset = false );
+
+	/** Progress non-blocking initialization
+	 *
+	 * @return kStatus_Busy while in progress, kStatus_Success when done, kStatus_Timeout when the device didn't get ready
+	 */
+	virtual status_t begin_poll( void );
+
+	/** Set system-level config registers */
+	virtual void boot( void );
+
+	/** Issue RESET command
+	 *
+	 * @return kStatus_Success or kStatus_Timeout if the device didn't get ready
+	 */
+	virtual status_t reset( bool hardware_reset = false );
+	
+	/** Configure logical channel
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param cc0	16bit value to be set CH_CONFIG0 register (0x20)
+	 * @param cc1	16bit value to be set CH_CONFIG1 register (0x21)
+	 * @param cc2	16bit value to be set CH_CONFIG2 register (0x22)
+	 * @param cc3	16bit value to be set CH_CONFIG3 register (0x23)
+	 */
+	virtual void logical_ch_config( int ch, uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t cc3 );
+
+	/** Configure logical channel
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param cc array for CH_CONFIG0, CH_CONFIG1, CH_CONFIG2 and CH_CONFIG3 values
+	 */
+	virtual void logical_ch_config( int ch, const uint16_t (&cc)[ 4 ] );
+
+	/** Logical channel disable
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 */
+	virtual void logical_ch_disable( int ch );
+
+	/** Data rate of logical channel
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @return data rate in SPS given by ADC_DATA_RATE setting, 0 if the channel is not configured
+	 */
+	double	data_rate( int ch );
+
+	/** PGA gain change
+	 *
+	 *	Rewrites CH_GAIN and CH_CAL_GAIN_OFFSET of a logical channel. Other settings are kept. 
+	 *	coeff_uV is updated together, so the readouts after this call are converted with new gain. 
+	 *	Registers are written from cached values, no register read is done. 
+	 *	
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param pga_gain_index PGA gain index (0 ~ 7)
+	 * @param coeff_slot coefficient slot for the gain, -1 to use pga_gain_index
+	 * @return false if the channel is disabled or not a HV input channel
+	 */
+	bool	pga_gain( int ch, int pga_gain_index, int coeff_slot = -1 );
+
+	/** PGA gain index of logical channel
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @return CH_GAIN value, -1 if the channel is disabled or not a HV input channel
+	 */
+	int		pga_gain( int ch );
+
+	/** ADC channel read
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 */
+	virtual int32_t	adc_read( int ch ) final
+	{
+		return reg( Register24::CH_DATA0 + ch );
+	}
+
+	/** Start ADC
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 */
+	virtual void start( int ch ) final
+	{
+		write_commands( ch, CMD_SS );
+	}
+
+	/** Read ADC
+	 *	
+	 *	Same as AFE_base::read() but start() and adc_read() are bound in compile time. 
+	 *	The path down to the SPI transfer can be inlined. 
+	 *	AFE_base::read() is still available through AFE_base reference.
+	 *	
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param delay ADC result read-out delay after measurement start if given
+	 * @return ADC readout value
+	 */
+	template<class T>
+	T read( int ch, float delay = immidiate_read )
+	{
+		start_and_delay( ch, delay, [ this ]( int c ) { NAFE_Base::start( c ); } );
+
+		return convert<T>( ch, NAFE_Base::adc_read( ch ) );
+	}
+
+	/** Multi-channel read
+	 *
+	 *	Starts a multi-channel single conversion (CMD_MS) and reads out the channels at DRDY. 
+	 *	Conversion is done for all logical channels enabled in CH_CONFIG4, in logical channel order. 
+	 *	Only the channels in "channels" are read out, with nonlinearity correction as read<raw_t>(). 
+	 *	DRDY need to come at end of the sequence (SYS_CONFIG0 DRDY_PIN_SEQ = 1, set by begin()). 
+	 *	If it is not, the mode is set during the sequence and SYS_CONFIG0 is restored after. 
+	 *	The SYS_CONFIG0 value is tracked by begin(), reset() and restore(), don't write it by reg() directly. 
+	 *	
+	 * @param channels bitmap of logical channels to be read
+	 * @param data array to store readouts, indexed by logical channel number
+	 * @param timeout maximum time to wait DRDY in seconds
+	 * @return false if DRDY didn't come in timeout. Readouts are done anyway
+	 */
+	bool	sequence_read( uint16_t channels, raw_t *data, float timeout );
+
+	/** Burst data read
+	 *
+	 *	Reads CH_DATA of all enabled logical channels in one SPI frame by CMD_BURST_DATA. 
+	 *	The packed 24 bit data are unpacked by unpack24(). 
+	 *	Readouts get nonlinearity correction as read<raw_t>(). 
+	 *	
+	 * @param channels bitmap of logical channels enabled in CH_CONFIG4
+	 * @param data array to store readouts, indexed by logical channel number
+	 * @return number of channels read
+	 */
+	int		burst_read( uint16_t channels, raw_t *data );
+
+	/** I/O setting for a conversion
+	 *	
+	 *	GPO and excitation changes to be made before a conversion. 
+	 *	Can be placed in flash as a constant.
+	 */
+	typedef struct	_io_setting	{
+		uint16_t	gpo_mask;		//	GPO_DATA bits to be changed
+		uint16_t	gpo_data;		//	GPO_DATA value for the bits in gpo_mask
+		int32_t		ch_config3;		//	CH_CONFIG3 value (excitation setting) of the channel, -1 to keep
+		float		settle;			//	wait in seconds between the change and conversion start, 0 for none
+	} io_setting;
+
+	/** Start ADC with I/O setting
+	 *	
+	 *	GPO_DATA write, channel pointer, CH_CONFIG3 write and CMD_SS are queued in one SPI burst. 
+	 *	Registers which already have the value are not written. 
+	 *	Settling after the change can be done by CH_DELAY of the channel in the same burst. 
+	 *	If io.settle is given, the burst is split and CMD_SS is sent after the wait. 
+	 *	
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param io I/O setting
+	 */
+	void	start( int ch, const io_setting &io );
+
+	/** Read ADC with I/O setting
+	 *	
+	 *	Does start( ch, io ) and reads out at DRDY, with nonlinearity correction as read<raw_t>()
+	 *	
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param io I/O setting
+	 * @param data reference to store readout
+	 * @param timeout maximum time to wait DRDY in seconds, after settling
+	 * @return false if DRDY didn't come in timeout. Readout is done anyway
+	 */
+	bool	io_read( int ch, const io_setting &io, raw_t &data, float timeout );
+
+	/** GPO output
+	 *	
+	 *	Writes GPO_DATA only when the value changes. 
+	 *	Pins need to be configured as output by GPIO_CONFIGx registers.
+	 *	
+	 * @param mask bits to be changed
+	 * @param value value for the bits in mask
+	 */
+	void	gpo( uint16_t mask, uint16_t value );
+
+	/** GPO output state
+	 *	
+	 * @return last GPO_DATA value written
+	 */
+	uint16_t	gpo( void )	{ return gpo_data; }
+
+	/** Fetch register into local image
+	 *
+	 *	Field access on the image can be done without SPI transfer. 
+	 *	Use store() to write it back.
+	 *	
+	 * @tparam r register specified by Register16 member
+	 * @return register image
+	 */
+	template<Register16 r>
+	reg16_image<r>	fetch( void )
+	{
+		return reg16_image<r>( reg( r ) );
+	}
+
+	/** Fetch register into local image
+	 *
+	 * @tparam r register specified by Register24 member
+	 * @return register image
+	 */
+	template<Register24 r>
+	reg24_image<r>	fetch( void )
+	{
+		return reg24_image<r>( reg( r ) );
+	}
+
+	/** Store local register image
+	 *
+	 *	Writes register once, only if one or more fields have been modified
+	 *	
+	 * @param image register image
+	 */
+	template<typename R, R r, typename V>
+	void	store( reg_image<R, r, V>& image )
+	{
+		if ( !image.modified )
+			return;
+
+		reg( r, image.value );
+		image.modified	= false;
+	}
+
+	/** Read a bit field
+	 *
+	 * @tparam F bit field descriptor
+	 * @return field value
+	 */
+	template<class F>
+	uint32_t	field( void )
+	{
+		return F::get( reg( F::reg ) );
+	}
+
+	/** Write a bit field (read-modify-write)
+	 *
+	 * @tparam F bit field descriptor
+	 * @param value field value
+	 */
+	template<class F>
+	void		field( uint32_t value )
+	{
+		reg( F::reg, F::set( reg( F::reg ), value ) );
+	}
+
 	/** Command
 	 *	
 	 * @param com "Comand" type or uint16_t value
 	 */
-	virtual void		command( uint16_t com );
+	void		command( uint16_t com )
+	{
+		write_r16( com );
+	}
 
 	/** Write register
 	 *
 	 *	Writes register. Register width is selected by reg type (Register16 ot Register24)
 	 * @param reg register specified by Register16 member
 	 */
-	virtual void		reg( Register16 r, uint16_t value );
+	void		reg( Register16 r, uint16_t value )
+	{
+		write_r16( static_cast<uint16_t>( r ), value );
+	}
 
 	/** Write register
 	 *
 	 *	Writes register. Register width is selected by reg type (Register16 ot Register24)
 	 * @param reg register specified by Register24 member
 	 */
-	virtual void		reg( Register24 r, uint32_t value );
+	void		reg( Register24 r, uint32_t value )
+	{
+		write_r24( static_cast<uint16_t>( r ), value );
+	}
 
 	/** Read register
 	 *
@@ -415,7 +928,10 @@ public:
 	 * @param reg register specified by Register16 member
 	 * @return readout value
 	 */
-	virtual uint16_t	reg( Register16 r );
+	uint16_t	reg( Register16 r )
+	{
+		return read_r16( static_cast<uint16_t>( r ) );
+	}
 
 	/** Read register
 	 *
@@ -423,7 +939,10 @@ public:
 	 * @param reg register specified by Register24 member
 	 * @return readout value
 	 */
-	virtual uint32_t	reg( Register24 r );
+	uint32_t	reg( Register24 r )
+	{
+		return read_r24( static_cast<uint16_t>( r ) );
+	}
 	
 	/** Register bit operation
 	 *
@@ -470,10 +989,268 @@ public:
 	float	temperature( void );
 	
 	void	gain_offset_coeff( const ref_points &ref );
-	void	recalibrate( int pga_gain_index, bool use_positive_side = true, int ch_GND = 14, int ch_REF = 15 );
+
+	/** Gain and offset coefficients from multiple reference points
+	 *
+	 *	Weighted least-squares version of gain_offset_coeff( const ref_points &ref ). 
+	 *	Slope and offset are fitted over all points then written into GAIN_COEFF and OFFSET_COEFF. 
+	 *	
+	 * @param points reference points: input voltage and ADC data measured with cal_index coefficients
+	 * @param n number of points (2 ~ max_reference_points)
+	 * @param coeff_index coefficient index to be written
+	 * @param cal_index coefficient index used for the measurement
+	 * @param result (option) pointer to get fitting result. slope is in ADC counts/V, residuals in ADC counts
+	 * @param weights (option) relative weight for each point. nullptr for equal weights
+	 * @return false if fitting failed. Registers are not written in that case
+	 */
+	bool	gain_offset_coeff( const reference_point *points, int n, int coeff_index, int cal_index, fit_result *result = nullptr, const float *weights = nullptr );
+
+	constexpr static int	max_reference_points	= 16;
+
+	/** Result of recalibrate() */
+	typedef struct	_cal_result	{
+		int			gain_index;		//	PGA gain index (coefficient slot)
+		uint32_t	gain_coeff;		//	GAIN_COEFF after calibration
+		int32_t		offset_coeff;	//	OFFSET_COEFF after calibration
+		float		gain_factor;	//	GAIN_COEFF change ratio (new / old)
+		int32_t		offset_delta;	//	OFFSET_COEFF change (new - old)
+		float		temperature;	//	die temperature at calibration
+		float		time;			//	seconds taken by the calibration readings
+		bool		settled;		//	false if the readings didn't settle. Coefficients are not written in that case
+	} cal_result;
+
+	/** On-board recalibration
+	 *
+	 *	Updates GAIN_COEFF and OFFSET_COEFF for a PGA gain using internal reference. 
+	 *	
+	 * @param pga_gain_index PGA gain index (0 ~ 7)
+	 * @param use_positive_side reference voltage on AIP side if true, AIN side if false
+	 * @param ch_GND logical channel used for GND measurement
+	 * @param ch_REF logical channel used for reference measurement
+	 * @param result (option) pointer to get the calibration result
+	 * @return false if the readings didn't settle in cal_settling_conversions conversions. Coefficients are not written in that case
+	 */
+	bool	recalibrate( int pga_gain_index, bool use_positive_side = true, int ch_GND = 14, int ch_REF = 15, cal_result *result = nullptr );
+
+	/** Result of recalibrate_both_sides() */
+	typedef struct	_polarity_cal_result	{
+		cal_result	result;			//	written coefficients, gain_factor is for mean of both sides
+		float		gain_positive;	//	gain correction measured on AIP side
+		float		gain_negative;	//	gain correction measured on AIN side
+		float		symmetry;		//	(gain_positive - gain_negative) / mean in ppm
+		bool		settled;		//	false if the readings didn't settle. Coefficients are not written in that case
+	} polarity_cal_result;
+
+	/** On-board recalibration for both input polarities
+	 *
+	 *	Measures reference on AIP side, on AIN side and GND in one multi-channel sequence. 
+	 *	GAIN_COEFF is set by mean of gain corrections of both sides. 
+	 *	Other logical channels are not converted during the calibration. 
+	 *	
+	 * @param pga_gain_index PGA gain index (0 ~ 7)
+	 * @param ch_GND logical channel used for GND measurement
+	 * @param ch_REFP logical channel used for reference measurement on AIP side
+	 * @param ch_REFN logical channel used for reference measurement on AIN side
+	 * @param result (option) pointer to get the calibration result
+	 * @return false if the readings didn't settle in cal_settling_conversions passes. Coefficients are not written in that case
+	 */
+	bool	recalibrate_both_sides( int pga_gain_index, int ch_GND = 13, int ch_REFP = 14, int ch_REFN = 15, polarity_cal_result *result = nullptr );
+
+	/** Device register state
+	 *	
+	 *	Channel registers of disabled logical channels are not captured and kept zero. 
+	 *	Two states can be compared by "==" to find device state change.
+	 */
+	typedef struct	_device_state	{
+		uint32_t	gain_coeff[ traits::coeff_slots ];
+		uint32_t	offset_coeff[ traits::coeff_slots ];
+		uint32_t	ch_config5[ traits::logical_channels ];
+		uint32_t	ch_config6[ traits::logical_channels ];
+		uint16_t	ch_config[ traits::logical_channels ][ 4 ];
+		uint16_t	ch_config4;
+		uint16_t	sys_config0;
+		uint16_t	gpio_config[ 3 ];
+		uint16_t	gpo_data;
+		uint16_t	global_alarm_enable;
+		uint16_t	thrs_temp;
+
+		bool operator==( const _device_state& ) const = default;
+	} device_state;
+
+	/** Capture device state
+	 *
+	 *	Reads logical channel settings, system config and coefficients. 
+	 *	The channel pointer is switched only once for each enabled logical channel.
+	 *	
+	 * @param state reference to device_state to store register values
+	 */
+	void	snapshot( device_state &state );
+
+	/** Restore device state
+	 *
+	 *	Writes back registers captured by snapshot() without reading. 
+	 *	This can be used for warm restart after reset().
+	 *	
+	 * @param state register values to be written
+	 */
+	void	restore( const device_state &state );
+
+	/** Gain/offset coefficient set
+	 *	
+	 *	Holds GAIN_COEFF and OFFSET_COEFF values for slots given by "slots" bitmap. 
+	 *	Can be placed in flash as a constant.
+	 */
+	typedef struct	_coeff_set	{
+		uint32_t	gain[ traits::coeff_slots ];
+		uint32_t	offset[ traits::coeff_slots ];
+		uint16_t	slots;
+	} coeff_set;
+
+	/** Save coefficients
+	 *
+	 * @param set reference to coeff_set to store register values
+	 * @param slots bitmap of coefficient slots to be saved
+	 */
+	void	coeff_save( coeff_set &set, uint16_t slots = 0xFFFF );
+
+	/** Load coefficients
+	 *
+	 *	Writes GAIN_COEFF and OFFSET_COEFF for the slots in set.slots only. 
+	 *	Logical channel settings are not touched. 
+	 *	
+	 * @param set coefficients to be written
+	 */
+	void	coeff_load( const coeff_set &set );
+
+	/** Coefficient slot used by logical channel
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @return CH_CAL_GAIN_OFFSET value, -1 if the channel is disabled
+	 */
+	int		cal_slot( int ch );
+
+	/** Logical channels using coefficient slots
+	 *
+	 * @param slots bitmap of coefficient slots
+	 * @return bitmap of logical channels referring one or more of given slots
+	 */
+	uint16_t	slot_users( uint16_t slots );
+
+	/** GLOBAL_ALARM_ENABLE and GLOBAL_ALARM_INTERRUPT bits */
+	enum GlobalAlarm : uint16_t {
+		ALARM_TEMP			= 0x1 << 14,
+		ALARM_ALL			= 0xFFFF,
+	};
+
+	/** Alarm event types */
+	enum class EventType : uint8_t {
+		CH_OVER_THRESHOLD,	//	CH_STATUS0 bit: data went over CH_CONFIG5 threshold
+		CH_UNDER_THRESHOLD,	//	CH_STATUS1 bit: data went under CH_CONFIG6 threshold
+		OVER_TEMPERATURE,	//	die temperature crossed THRS_TEMP
+		GLOBAL_ALARM,		//	other GLOBAL_ALARM_INTERRUPT bits
+	};
+
+	typedef struct	_event	{
+		EventType	type;
+		int			ch;		//	logical channel number for CH_* events, -1 for others
+		uint16_t	value;	//	DIE_TEMP for OVER_TEMPERATURE, GLOBAL_ALARM_INTERRUPT bits for GLOBAL_ALARM
+	} event;
+
+	/** Alarm enable
+	 *
+	 *	Sets GLOBAL_ALARM_ENABLE, clears pending alarms and starts watching nINT pin
+	 *
+	 * @param mask GLOBAL_ALARM_ENABLE value
+	 */
+	void	alarm_enable( uint16_t mask = ALARM_ALL );
+
+	/** Alarm disable */
+	void	alarm_disable( void );
+
+	/** Logical channel threshold setting
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param high threshold for CH_STATUS0 (CH_CONFIG5)
+	 * @param low threshold for CH_STATUS1 (CH_CONFIG6)
+	 */
+	void	threshold( int ch, int32_t high, int32_t low );
+
+	/** Alarm service
+	 *	
+	 *	Decodes alarm status into events when nINT has been asserted. 
+	 *	Call this in main loop. It does nothing (no SPI access) if nINT was not asserted.
+	 *
+	 * @return number of events queued in this call
+	 */
+	int		alarm_service( void );
+
+	/** Get an alarm event
+	 *
+	 * @param e reference to receive the oldest event
+	 * @return false if no event available
+	 */
+	bool	event_get( event &e );
+
+private:
+	void	coeff_update( int ch, uint16_t cc0 );
+	void	timing_update( int ch, uint16_t cc1, uint16_t cc2 );
+	void	coeff_write( int coeff_index, int cal_index, double slope, double intercept );
+	void	cal_reference( int pga_gain_index, HVInput &source, double &voltage );
+	double	cal_gain( int pga_gain_index, double reference_voltage, raw_t span );
+	void	cal_write( int pga_gain_index, double calibrated_gain, raw_t data_GND, cal_result *result );
+	bool	sequence_settled( uint16_t channels, raw_t *data, int32_t threshold, int max_passes );
+	void	boot_io( void );
+	void	boot_sys( void );
+	void	step_next( int step, float delay );
+	bool	step_due( void );
+
+	enum BootStep : uint8_t {
+		BOOT_IDLE,
+		BOOT_RESET_PULSE,
+		BOOT_WAIT_READY,
+		BOOT_IO,
+		BOOT_SYS,
+		BOOT_DONE,
+		BOOT_TIMEOUT,
+	};
+
+	constexpr static float	reset_pulse_width	= 0.001;
+	constexpr static float	ready_poll_interval	= 0.003;
+	constexpr static int	ready_poll_retry	= 10;
+	constexpr static float	boot_settle_time	= 0.001;
+
+	/** Margin for estimated conversion time */
+	constexpr static double	conversion_time_margin	= 1.1;
+
+	/** Conversion time of calibration setting: SINC filter settles in (order + 1) output periods, with margin */
+	constexpr static double		cal_conversion_time			= (traits::cal_sinc + 1) / traits::data_rate[ traits::cal_data_rate ] * conversion_time_margin;
+
+	/** Calibration readings need to settle within this number of conversions */
+	constexpr static int		cal_settling_conversions	= 4;
+	constexpr static int32_t	cal_settling_threshold		= 16;
+
+	int8_t		ch_cal_slot[ traits::logical_channels ];
+	uint16_t	ch_config0[ traits::logical_channels ];
+	uint16_t	ch_config1[ traits::logical_channels ];
+	uint16_t	ch_config3[ traits::logical_channels ];
+	uint16_t	sys_config0;
+	uint16_t	gpo_data;
+
+	uint8_t		boot_step;
+	int			boot_retry;
+	uint32_t	step_time;
+
+	constexpr static int		event_queue_length	= 16;
+	RingBuffer<event, event_queue_length>	events;
+
+	void	event_put( EventType type, int ch, uint16_t value );
 };
 
-class NAFE13388 : public NAFE13388_Base
+using NAFE13388_Base	= NAFE_Base<NAFE13388_traits>;
+
+extern template class NAFE_Base<NAFE13388_traits>;
+
+class NAFE13388 final : public NAFE13388_Base
 {
 public:	
 	/** Constructor to create a NAFE13388 instance */
@@ -483,7 +1260,7 @@ public:
 	virtual ~NAFE13388();
 };
 
-class NAFE13388_UIM : public NAFE13388_Base
+class NAFE13388_UIM final : public NAFE13388_Base
 {
 public:	
 	/** Constructor to create a NAFE13388 instance */
@@ -0,0 +1,148 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"AutoRange.h"
+#include	<stdlib.h>
+
+template<class traits>
+AutoRange<traits>::AutoRange( NAFE_Base<traits>& afe_ ) : afe( afe_ ), enabled( 0 )
+{
+	for ( auto ch = 0; ch < channels; ch++ )
+	{
+		gain[ ch ]			= 0;
+		min_gain[ ch ]		= 0;
+		max_gain[ ch ]		= gains - 1;
+		under_count[ ch ]	= 0;
+		switch_count[ ch ]	= 0;
+	}
+
+	for ( auto i = 0; i < gains; i++ )
+		slot[ i ]	= i;
+
+	thresholds( 0.9, 0.6, 8 );
+}
+
+template<class traits>
+AutoRange<traits>::~AutoRange()
+{
+}
+
+template<class traits>
+bool AutoRange<traits>::enable( int ch, int min_gain_index, int max_gain_index )
+{
+	const int	current	= afe.pga_gain( ch );
+
+	if ( current < 0 )
+		return false;
+
+	min_gain_index	= (min_gain_index < 0) ? 0 : min_gain_index;
+	max_gain_index	= (gains <= max_gain_index) ? gains - 1 : max_gain_index;
+
+	if ( max_gain_index < min_gain_index )
+		return false;
+
+	min_gain[ ch ]		= min_gain_index;
+	max_gain[ ch ]		= max_gain_index;
+	gain[ ch ]			= current;
+	under_count[ ch ]	= 0;
+	enabled			   |= 0x1 << ch;
+
+	if ( current < min_gain_index )
+		change( ch, min_gain_index );
+	else if ( max_gain_index < current )
+		change( ch, max_gain_index );
+
+	return true;
+}
+
+template<class traits>
+void AutoRange<traits>::disable( int ch )
+{
+	enabled	&= ~(0x1 << ch);
+}
+
+template<class traits>
+void AutoRange<traits>::thresholds( float high, float low, int hold )
+{
+	high_level	= (raw_t)(full_scale * high);
+	low_ratio	= low;
+	hold_count	= (hold < 1) ? 1 : hold;
+}
+
+template<class traits>
+void AutoRange<traits>::slot_map( const int8_t (&map)[ gains ] )
+{
+	for ( auto i = 0; i < gains; i++ )
+		slot[ i ]	= map[ i ];
+}
+
+template<class traits>
+typename AutoRange<traits>::microvolt_t AutoRange<traits>::process( int ch, raw_t raw )
+{
+	const microvolt_t	uV	= raw * afe.coeff_uV[ ch ];
+
+	if ( !(enabled & (0x1 << ch)) )
+		return uV;
+
+	const raw_t	level	= labs( raw );
+	const int	g		= gain[ ch ];
+
+	if ( high_level < level )
+	{
+		//	over range: step down at once. Two steps if the readout is clipped
+
+		int	next	= g - ((full_scale - 1 <= level) ? 2 : 1);
+
+		under_count[ ch ]	= 0;
+		change( ch, (next < min_gain[ ch ]) ? min_gain[ ch ] : next );
+	}
+	else if ( g < max_gain[ ch ] )
+	{
+		//	under range: step up after "hold" samples which fit in low threshold with next gain
+
+		const double	step	= traits::pga_gain[ g + 1 ] / traits::pga_gain[ g ];
+
+		if ( level * step < full_scale * low_ratio )
+		{
+			if ( hold_count <= ++under_count[ ch ] )
+			{
+				under_count[ ch ]	= 0;
+				change( ch, g + 1 );
+			}
+		}
+		else
+		{
+			under_count[ ch ]	= 0;
+		}
+	}
+
+	return uV;
+}
+
+template<class traits>
+typename AutoRange<traits>::microvolt_t AutoRange<traits>::read( int ch, float delay )
+{
+	return process( ch, afe.template read<raw_t>( ch, delay ) );
+}
+
+template<class traits>
+bool AutoRange<traits>::change( int ch, int index )
+{
+	if ( index == gain[ ch ] )
+		return false;
+
+	if ( !afe.pga_gain( ch, index, slot[ index ] ) )
+		return false;
+
+	gain[ ch ]	= index;
+	switch_count[ ch ]++;
+
+	return true;
+}
+
+template class AutoRange<NAFE13388_traits>;
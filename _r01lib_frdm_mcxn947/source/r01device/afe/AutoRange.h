@@ -0,0 +1,132 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Automatic PGA gain ranging
+ *
+ *	Readouts are watched against thresholds near full scale and near the bottom of the range.
+ *	PGA gain is lowered at once when a readout goes over the high threshold.
+ *	It is raised when the readouts would stay under the low threshold even after the gain step,
+ *	for "hold" successive samples. The gap between the thresholds and the hold count give the hysteresis.
+ *
+ *	Gain and coefficient slot are changed by NAFE_Base::pga_gain() which updates coeff_uV together.
+ *	Each sample is converted with the coefficient of the gain it was taken with.
+ *
+ *  Example:
+ *  @code
+ *  AutoRange	range( afe );
+ *
+ *  range.enable( 0 );	//	logical channel 0, all gains
+ *
+ *  while ( true )
+ *  	printf( "%lf µV (gain index %d)\r\n", range.read( 0 ), range.gain_index( 0 ) );
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_AUTO_RANGE_H
+#define ARDUINO_AFE_AUTO_RANGE_H
+
+#include	"AFE_NXP.h"
+
+/** AutoRange class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ */
+template<class traits>
+class AutoRange
+{
+public:
+	using raw_t			= AFE_base::raw_t;
+	using microvolt_t	= AFE_base::microvolt_t;
+
+	constexpr static int	channels	= traits::logical_channels;
+	constexpr static int	gains		= sizeof( traits::pga_gain ) / sizeof( traits::pga_gain[ 0 ] );
+
+	/** Create an AutoRange instance
+	 *
+	 * @param afe_ AFE instance
+	 */
+	AutoRange( NAFE_Base<traits>& afe_ );
+
+	/** Destructor */
+	virtual ~AutoRange();
+
+	/** Enable auto-ranging on a logical channel
+	 *
+	 *	Channel need to be configured as a HV input channel by logical_ch_config().
+	 *	Current gain is clamped into the range.
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param min_gain_index lowest PGA gain index to be used
+	 * @param max_gain_index highest PGA gain index to be used
+	 * @return false if the channel is not a HV input channel
+	 */
+	bool	enable( int ch, int min_gain_index = 0, int max_gain_index = gains - 1 );
+
+	/** Disable auto-ranging on a logical channel. The gain is kept as is */
+	void	disable( int ch );
+
+	/** Thresholds
+	 *
+	 * @param high ratio to full scale to lower the gain (0.0 ~ 1.0)
+	 * @param low ratio to full scale to raise the gain, applied to the readout after gain step (0.0 ~ high)
+	 * @param hold number of successive samples under the low threshold to raise the gain
+	 */
+	void	thresholds( float high, float low, int hold );
+
+	/** Coefficient slots for PGA gains
+	 *
+	 *	By default, slot of the same number as PGA gain index is used (as recalibrate() does)
+	 *
+	 * @param map coefficient slot for each PGA gain index
+	 */
+	void	slot_map( const int8_t (&map)[ gains ] );
+
+	/** Process a readout
+	 *
+	 *	Converts the readout with current coefficient, then switches the gain if needed.
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param raw ADC readout taken with current gain
+	 * @return readout in µV
+	 */
+	microvolt_t	process( int ch, raw_t raw );
+
+	/** Read a logical channel and process the readout
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param delay read delay, see AFE_base::read()
+	 * @return readout in µV
+	 */
+	microvolt_t	read( int ch, float delay = AFE_base::auto_delay );
+
+	/** Current PGA gain index of a logical channel */
+	int		gain_index( int ch ) const	{ return gain[ ch ]; }
+
+	/** Number of gain changes on a logical channel */
+	uint32_t	switches( int ch ) const	{ return switch_count[ ch ]; }
+
+private:
+	bool	change( int ch, int index );
+
+	constexpr static raw_t	full_scale	= 0x1L << (traits::adc_resolution - 1);
+
+	NAFE_Base<traits>&	afe;
+	uint16_t		enabled;
+	int8_t			gain[ channels ];
+	int8_t			min_gain[ channels ];
+	int8_t			max_gain[ channels ];
+	uint16_t		under_count[ channels ];
+	uint32_t		switch_count[ channels ];
+	int8_t			slot[ gains ];
+	raw_t			high_level;
+	float			low_ratio;
+	int				hold_count;
+};
+
+extern template class AutoRange<NAFE13388_traits>;
+
+#endif //	ARDUINO_AFE_AUTO_RANGE_H
@@ -0,0 +1,177 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Calibration profile bank
+ *
+ *	Keeps more coefficient sets than the 16 GAIN_COEFF/OFFSET_COEFF slots of the device. 
+ *	A profile is a coeff_set, which can be captured from device into RAM or given as a constant in flash. 
+ *	Selecting a profile writes only its slots and logical channel settings are not touched. 
+ *	So range/profile switch is done without reconfiguring channels. 
+ *
+ *  Example:
+ *  @code
+ *  CalibrationBank<NAFE13388_traits, 8>	bank( afe );
+ *  
+ *  afe.gain_offset_coeff( r_5V );
+ *  int	p5	= bank.capture( 0x1 << CAL_CUSTOM );	//	save slot CAL_CUSTOM as a profile
+ *  
+ *  afe.gain_offset_coeff( r_10V );
+ *  int	p10	= bank.capture( 0x1 << CAL_CUSTOM );
+ *  
+ *  bank.select( p5 );	//	logical channels using CAL_CUSTOM slot measure in 5V range
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_CALIBRATION_BANK_H
+#define ARDUINO_AFE_CALIBRATION_BANK_H
+
+#include	"AFE_NXP.h"
+
+/** CalibrationBank class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ * @tparam N maximum number of profiles
+ */
+template<class traits, int N = 8>
+class CalibrationBank
+{
+public:
+	using coeff_set	= typename NAFE_Base<traits>::coeff_set;
+
+	constexpr static int	coeff_slots	= traits::coeff_slots;
+	
+	constexpr static int	no_profile	= -1;
+
+	/** Create a CalibrationBank instance
+	 *
+	 * @param afe_ AFE instance
+	 */
+	CalibrationBank( NAFE_Base<traits>& afe_ ) : afe( afe_ ), count( 0 )
+	{
+		invalidate();
+	}
+
+	/** Register a profile without copying
+	 *
+	 *	The profile need to be kept while the bank is used (e.g. a constant in flash)
+	 *	
+	 * @param set pointer to a coeff_set
+	 * @return profile ID, no_profile if the bank is full
+	 */
+	int	add( const coeff_set *set )
+	{
+		if ( N <= count )
+			return no_profile;
+
+		profiles[ count ]	= set;
+		return count++;
+	}
+
+	/** Capture device coefficients as a new profile
+	 *
+	 * @param slots bitmap of coefficient slots to be captured
+	 * @return profile ID, no_profile if the bank is full
+	 */
+	int	capture( uint16_t slots )
+	{
+		if ( N <= count )
+			return no_profile;
+
+		afe.coeff_save( storage[ count ], slots );
+		
+		for ( auto i = 0; i < coeff_slots; i++ )
+			if ( slots & (0x1 << i) )
+				loaded[ i ]	= count;
+		
+		return add( &storage[ count ] );
+	}
+
+	/** Select a profile
+	 *
+	 *	Slots which already hold the profile are not written. 
+	 *	
+	 * @param id profile ID
+	 * @return false if the ID is invalid
+	 */
+	bool	select( int id )
+	{
+		if ( (id < 0) || (count <= id) )
+			return false;
+
+		const coeff_set	&s	= *profiles[ id ];
+		coeff_set		tmp	= s;
+		
+		tmp.slots	= 0;
+
+		for ( auto i = 0; i < coeff_slots; i++ )
+		{
+			if ( (s.slots & (0x1 << i)) && (loaded[ i ] != id) )
+			{
+				tmp.slots	|= 0x1 << i;
+				loaded[ i ]	 = id;
+			}
+		}
+		
+		afe.coeff_load( tmp );
+		return true;
+	}
+
+	/** Profile held in a coefficient slot
+	 *
+	 * @param slot coefficient slot (0 ~ 15)
+	 * @return profile ID, no_profile if unknown
+	 */
+	int	profile_in( int slot ) const
+	{
+		return loaded[ slot ];
+	}
+
+	/** Logical channels affected by a profile
+	 *
+	 * @param id profile ID
+	 * @return bitmap of logical channels referring slots of the profile
+	 */
+	uint16_t	users( int id )
+	{
+		if ( (id < 0) || (count <= id) )
+			return 0;
+
+		return afe.slot_users( profiles[ id ]->slots );
+	}
+
+	/** Forget loaded state
+	 *
+	 *	Call this after coefficients were changed without the bank (e.g. recalibrate() or reset())
+	 */
+	void	invalidate( void )
+	{
+		for ( auto i = 0; i < coeff_slots; i++ )
+			loaded[ i ]	= no_profile;
+	}
+
+	/** Number of profiles */
+	int	size( void ) const	{ return count; }
+
+	/** Get a profile
+	 *
+	 * @param id profile ID
+	 * @return pointer to the profile, nullptr if the ID is invalid
+	 */
+	const coeff_set	*profile( int id ) const
+	{
+		return ((0 <= id) && (id < count)) ? profiles[ id ] : nullptr;
+	}
+
+private:
+	NAFE_Base<traits>&	afe;
+	const coeff_set		*profiles[ N ];
+	coeff_set			storage[ N ];
+	int					loaded[ coeff_slots ];
+	int					count;
+};
+
+#endif //	ARDUINO_AFE_CALIBRATION_BANK_H
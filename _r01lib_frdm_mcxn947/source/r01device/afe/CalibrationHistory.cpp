@@ -0,0 +1,188 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"CalibrationHistory.h"
+#include	"linear_fit.h"
+#include	<string.h>
+#include	<math.h>
+
+template<class traits>
+CalibrationHistory<traits>::CalibrationHistory()
+{
+	clear();
+}
+
+template<class traits>
+CalibrationHistory<traits>::~CalibrationHistory()
+{
+}
+
+template<class traits>
+void CalibrationHistory<traits>::clear( int gain_index )
+{
+	if ( gain_index < 0 )
+	{
+		memset( &hist, 0, sizeof( hist ) );
+		hist.magic	= image_magic;
+	}
+	else if ( gain_index < gain_indices )
+	{
+		hist.head[ gain_index ]		= 0;
+		hist.count[ gain_index ]	= 0;
+	}
+}
+
+template<class traits>
+void CalibrationHistory<traits>::add( const typename NAFE_Base<traits>::cal_result &result, uint32_t time )
+{
+	const int	g	= result.gain_index;
+
+	if ( (g < 0) || (gain_indices <= g) || !result.settled )
+		return;
+
+	record	&r	= hist.records[ g ][ hist.head[ g ] ];
+
+	r.time			= time;
+	r.gain_coeff	= result.gain_coeff;
+	r.offset_coeff	= result.offset_coeff;
+	r.gain_factor	= result.gain_factor;
+	r.offset_delta	= result.offset_delta;
+	r.temperature	= result.temperature;
+
+	hist.head[ g ]	= (hist.head[ g ] + 1) % depth;
+
+	if ( hist.count[ g ] < depth )
+		hist.count[ g ]++;
+}
+
+template<class traits>
+int CalibrationHistory<traits>::size( int gain_index ) const
+{
+	return ((0 <= gain_index) && (gain_index < gain_indices)) ? hist.count[ gain_index ] : 0;
+}
+
+template<class traits>
+const typename CalibrationHistory<traits>::record *CalibrationHistory<traits>::get( int gain_index, int age ) const
+{
+	if ( (age < 0) || (size( gain_index ) <= age) )
+		return nullptr;
+
+	return &hist.records[ gain_index ][ (hist.head[ gain_index ] + depth - 1 - age) % depth ];
+}
+
+template<class traits>
+bool CalibrationHistory<traits>::drift( int gain_index, drift_estimate &d ) const
+{
+	const int	n	= size( gain_index );
+
+	if ( n < 2 )
+		return false;
+
+	//	oldest record is the reference for time and gain
+
+	const record	*ref	= get( gain_index, n - 1 );
+	fit_point		gain_points[ depth ];
+	fit_point		offset_points[ depth ];
+	fit_result		gain_fit;
+	fit_result		offset_fit;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		const record	*r		= get( gain_index, n - 1 - i );
+		const float		hours	= (int32_t)(r->time - ref->time) / 3600.0;
+
+		gain_points[ i ]	= { hours, (float)(((double)r->gain_coeff / (double)ref->gain_coeff - 1.0) * 1e6), 1.0 };
+		offset_points[ i ]	= { hours, (float)(r->offset_coeff - ref->offset_coeff), 1.0 };
+	}
+
+	if ( !linear_fit( gain_points, n, gain_fit ) || !linear_fit( offset_points, n, offset_fit ) )
+		return false;
+
+	d.gain_rate		= gain_fit.slope;
+	d.offset_rate	= offset_fit.slope;
+	d.gain_sigma	= gain_fit.rms_residual;
+	d.offset_sigma	= offset_fit.rms_residual;
+	d.samples		= n;
+
+	return true;
+}
+
+template<class traits>
+bool CalibrationHistory<traits>::due( int gain_index, uint32_t now, float temperature, const limits &lim ) const
+{
+	const record	*last	= get( gain_index );
+
+	if ( !last )
+		return true;
+
+	const uint32_t	elapsed	= now - last->time;
+
+	if ( lim.max_interval && (lim.max_interval < elapsed) )
+		return true;
+
+	if ( lim.temperature < fabsf( temperature - last->temperature ) )
+		return true;
+
+	drift_estimate	d;
+
+	if ( !drift( gain_index, d ) )
+		return false;
+
+	const float	hours	= elapsed / 3600.0;
+
+	if ( lim.gain_ppm < fabsf( d.gain_rate * hours ) + d.gain_sigma )
+		return true;
+
+	if ( lim.offset_counts < fabsf( d.offset_rate * hours ) + d.offset_sigma )
+		return true;
+
+	return false;
+}
+
+template<class traits>
+const void *CalibrationHistory<traits>::image( void ) const
+{
+	return &hist;
+}
+
+template<class traits>
+int CalibrationHistory<traits>::image_size( void ) const
+{
+	return sizeof( hist );
+}
+
+template<class traits>
+bool CalibrationHistory<traits>::load( const void *data, int size )
+{
+	if ( size != (int)sizeof( hist ) )
+	{
+		clear();
+		return false;
+	}
+
+	memcpy( &hist, data, sizeof( hist ) );
+
+	for ( auto i = 0; i < gain_indices; i++ )
+	{
+		if ( (depth <= hist.head[ i ]) || (depth < hist.count[ i ]) )
+		{
+			clear();
+			return false;
+		}
+	}
+
+	if ( hist.magic != image_magic )
+	{
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+template class CalibrationHistory<NAFE13388_traits>;
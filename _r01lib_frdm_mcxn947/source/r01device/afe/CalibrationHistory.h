@@ -0,0 +1,156 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Calibration history and drift tracking
+ *
+ *	Keeps last results of recalibrate() for each PGA gain index in RAM. 
+ *	Drift rate and its uncertainty are estimated by line fit over the history. 
+ *	due() tells if the recalibration is needed by predicted drift, temperature change and elapsed time. 
+ *	
+ *	The history is a plain memory image. It can be persisted by writing image() to non-volatile memory. 
+ *
+ *  Example:
+ *  @code
+ *  CalibrationHistory<NAFE13388_traits>	history;
+ *  NAFE13388_Base::cal_result	r;
+ *  
+ *  if ( history.due( 0, rtc_seconds, afe.temperature() ) )
+ *  {
+ *  	afe.recalibrate( 0, true, 14, 15, &r );
+ *  	history.add( r, rtc_seconds );
+ *  	flash_write( history.image(), history.image_size() );	//	user storage function
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_CALIBRATION_HISTORY_H
+#define ARDUINO_AFE_CALIBRATION_HISTORY_H
+
+#include	<stdint.h>
+#include	"AFE_NXP.h"
+
+/** CalibrationHistory class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ */
+template<class traits>
+class CalibrationHistory
+{
+public:
+	constexpr static int	gain_indices	= sizeof( traits::pga_gain ) / sizeof( traits::pga_gain[ 0 ] );
+	constexpr static int	depth			= 8;
+
+	typedef struct	_record	{
+		uint32_t	time;			//	seconds, any epoch
+		uint32_t	gain_coeff;		//	GAIN_COEFF after calibration
+		int32_t		offset_coeff;	//	OFFSET_COEFF after calibration
+		float		gain_factor;	//	GAIN_COEFF change ratio at the calibration
+		int32_t		offset_delta;	//	OFFSET_COEFF change at the calibration
+		float		temperature;	//	die temperature
+	} record;
+
+	typedef struct	_drift_estimate	{
+		float	gain_rate;		//	ppm per hour
+		float	offset_rate;	//	ADC counts per hour
+		float	gain_sigma;		//	RMS residual of gain fit in ppm
+		float	offset_sigma;	//	RMS residual of offset fit in ADC counts
+		int		samples;		//	number of records used
+	} drift_estimate;
+
+	typedef struct	_limits	{
+		float		gain_ppm;		//	allowed gain drift
+		float		offset_counts;	//	allowed offset drift
+		float		temperature;	//	allowed die temperature change
+		uint32_t	max_interval;	//	maximum seconds between calibrations, 0 for no limit
+	} limits;
+
+	constexpr static limits	default_limits	= { 50.0, 100.0, 5.0, 7 * 24 * 3600 };
+
+	/** Create a CalibrationHistory instance with empty history */
+	CalibrationHistory();
+
+	/** Destructor */
+	virtual ~CalibrationHistory();
+
+	/** Clear history
+	 *
+	 * @param gain_index PGA gain index. -1 for all
+	 */
+	void	clear( int gain_index = -1 );
+
+	/** Add calibration result
+	 *
+	 *	The oldest record is overwritten when the history is full. 
+	 *	Results which didn't settle (settled == false) are ignored. 
+	 *	
+	 * @param result result from NAFE_Base::recalibrate()
+	 * @param time timestamp in seconds
+	 */
+	void	add( const typename NAFE_Base<traits>::cal_result &result, uint32_t time );
+
+	/** Number of records
+	 *
+	 * @param gain_index PGA gain index
+	 */
+	int		size( int gain_index ) const;
+
+	/** Get a record
+	 *
+	 * @param gain_index PGA gain index
+	 * @param age 0 for latest, 1 for one before, ...
+	 * @return pointer to record, nullptr if not available
+	 */
+	const record	*get( int gain_index, int age = 0 ) const;
+
+	/** Drift estimation
+	 *
+	 *	Needs 2 or more records. Sigma values are meaningful with 3 or more records. 
+	 *	
+	 * @param gain_index PGA gain index
+	 * @param d reference to drift_estimate to store the result
+	 * @return false if the estimation cannot be done
+	 */
+	bool	drift( int gain_index, drift_estimate &d ) const;
+
+	/** Check recalibration need
+	 *
+	 * @param gain_index PGA gain index
+	 * @param now current time in seconds
+	 * @param temperature current die temperature
+	 * @param lim limits
+	 * @return true if recalibration is recommended
+	 */
+	bool	due( int gain_index, uint32_t now, float temperature, const limits &lim = default_limits ) const;
+
+	/** Memory image for persistence */
+	const void	*image( void ) const;
+
+	/** Size of memory image in bytes */
+	int			image_size( void ) const;
+
+	/** Restore history from memory image
+	 *
+	 * @param data memory image written by image()
+	 * @param size size of data
+	 * @return false if the image is not valid. History is cleared in that case
+	 */
+	bool		load( const void *data, int size );
+
+private:
+	constexpr static uint32_t	image_magic	= 0x43414C48;	//	"CALH"
+
+	struct	{
+		uint32_t	magic;
+		uint8_t		head[ gain_indices ];
+		uint8_t		count[ gain_indices ];
+		record		records[ gain_indices ][ depth ];
+	} hist;
+};
+
+extern template class CalibrationHistory<NAFE13388_traits>;
+
+#endif //	ARDUINO_AFE_CALIBRATION_HISTORY_H
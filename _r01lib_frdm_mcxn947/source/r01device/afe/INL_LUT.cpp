@@ -0,0 +1,92 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"INL_LUT.h"
+
+INL_LUT::INL_LUT( int segments_log2 )
+{
+	if ( segments_log2 < 0 )
+		segments_log2	= 0;
+	else if ( max_segments_log2 < segments_log2 )
+		segments_log2	= max_segments_log2;
+
+	segments	= 0x1 << segments_log2;
+	shift		= adc_resolution - segments_log2;
+
+	clear();
+}
+
+INL_LUT::~INL_LUT()
+{
+}
+
+void INL_LUT::clear( void )
+{
+	for ( auto i = 0; i <= segments; i++ )
+		table[ i ]	= 0;
+}
+
+int INL_LUT::nodes( void ) const
+{
+	return segments + 1;
+}
+
+int32_t INL_LUT::node_code( int index ) const
+{
+	return (int32_t)(((int64_t)index << shift) - (0x1L << (adc_resolution - 1)));
+}
+
+void INL_LUT::node( int index, int32_t correction )
+{
+	if ( (0 <= index) && (index <= segments) )
+		table[ index ]	= correction;
+}
+
+bool INL_LUT::build( const int32_t *measured, const int32_t *ideal, int n )
+{
+	if ( n < 1 )
+		return false;
+
+	for ( auto i = 1; i < n; i++ )
+		if ( measured[ i ] <= measured[ i - 1 ] )
+			return false;
+
+	int	k	= 0;
+
+	for ( auto i = 0; i <= segments; i++ )
+	{
+		const int32_t	x	= node_code( i );
+
+		while ( (k < n - 2) && (measured[ k + 1 ] < x) )
+			k++;
+
+		if ( (n == 1) || (x <= measured[ 0 ]) )
+		{
+			table[ i ]	= ideal[ 0 ] - measured[ 0 ];
+		}
+		else if ( measured[ n - 1 ] <= x )
+		{
+			table[ i ]	= ideal[ n - 1 ] - measured[ n - 1 ];
+		}
+		else
+		{
+			const int64_t	e0	= ideal[ k     ] - measured[ k     ];
+			const int64_t	e1	= ideal[ k + 1 ] - measured[ k + 1 ];
+
+			table[ i ]	= (int32_t)(e0 + (e1 - e0) * (x - measured[ k ]) / (measured[ k + 1 ] - measured[ k ]));
+		}
+	}
+
+	return true;
+}
+
+void INL_LUT::apply( int32_t *data, int n ) const
+{
+	for ( auto i = 0; i < n; i++ )
+		data[ i ]	= correct( data[ i ] );
+}
@@ -0,0 +1,113 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Piecewise-linear nonlinearity correction for 24 bit ADC data
+ *
+ *	The 24 bit code range is split into 2^N segments of same width. 
+ *	Segment lookup is a shift and the correction is linear interpolation between nodes. 
+ *	Correction values are in ADC counts and added to the raw data. 
+ *
+ *  Example:
+ *  @code
+ *  INL_LUT	lut( 4 );	//	16 segments
+ *  
+ *  lut.build( measured, ideal, n );	//	from calibration data
+ *  afe.correction( 0, &lut );			//	applied in afe.read() for logical channel 0
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_INL_LUT_H
+#define ARDUINO_AFE_INL_LUT_H
+
+#include	<stdint.h>
+
+class INL_LUT
+{
+public:
+	constexpr static int	adc_resolution			= 24;
+	constexpr static int	max_segments_log2		= 6;
+
+	/** Create an INL_LUT instance
+	 *
+	 * @param segments_log2 number of segments in log2 (0 ~ max_segments_log2)
+	 */
+	INL_LUT( int segments_log2 = 4 );
+
+	/** Destructor */
+	virtual ~INL_LUT();
+
+	/** Clear all correction values to zero */
+	void	clear( void );
+
+	/** Number of nodes (segments + 1) */
+	int		nodes( void ) const;
+
+	/** ADC code of a node
+	 *
+	 * @param index node index (0 ~ nodes() - 1)
+	 * @return ADC code at the node
+	 */
+	int32_t	node_code( int index ) const;
+
+	/** Set correction value of a node
+	 *
+	 * @param index node index (0 ~ nodes() - 1)
+	 * @param correction correction value in ADC counts
+	 */
+	void	node( int index, int32_t correction );
+
+	/** Build table from calibration data
+	 *
+	 *	Correction at each node is interpolated from (ideal - measured) of given points. 
+	 *	Outside of the given range, the correction of the end point is used. 
+	 *
+	 * @param measured ADC readouts, in ascending order
+	 * @param ideal ideal ADC values for each readout
+	 * @param n number of points (1 or more)
+	 * @return false if the points are not in ascending order
+	 */
+	bool	build( const int32_t *measured, const int32_t *ideal, int n );
+
+	/** Correct single sample
+	 *
+	 * @param raw ADC readout
+	 * @return corrected value
+	 */
+	inline int32_t	correct( int32_t raw ) const
+	{
+		constexpr int32_t	half_scale	= 0x1L << (adc_resolution - 1);
+		constexpr int32_t	full_scale	= 0x1L << adc_resolution;
+
+		int32_t	u	= raw + half_scale;
+		
+		if ( u < 0 )
+			u	= 0;
+		else if ( full_scale <= u )
+			u	= full_scale - 1;
+
+		const int32_t	i	= u >> shift;
+		const int32_t	f	= u & ((0x1L << shift) - 1);
+		const int32_t	c0	= table[ i     ];
+		const int32_t	c1	= table[ i + 1 ];
+
+		return raw + c0 + (int32_t)(((int64_t)(c1 - c0) * f) >> shift);
+	}
+
+	/** Correct samples in array
+	 *
+	 * @param data ADC readouts. Corrected values are written back
+	 * @param n number of samples
+	 */
+	void	apply( int32_t *data, int n ) const;
+
+private:
+	int		shift;
+	int		segments;
+	int32_t	table[ (0x1 << max_segments_log2) + 1 ];
+};
+
+#endif //	ARDUINO_AFE_INL_LUT_H
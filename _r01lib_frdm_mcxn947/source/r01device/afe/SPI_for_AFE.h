@@ -19,45 +19,123 @@ public:
 	virtual ~SPI_for_AFE();
 	
 	/** Send data
+	 * 
+	 *	Uses register level SPI transfer. Received data overwrites the buffer
 	 * 
 	 * @param data pointer to data buffer
 	 * @param size data size
 	 */
-	void txrx( uint8_t *data, int size );
+	void txrx( uint8_t *data, int size )
+	{
+		_spi.write_fast( data, data, size );
+	}
+
+	/** Command pair
+	 *
+	 *	Two command frames are queued in one SPI transfer
+	 *
+	 * @param com0 first command
+	 * @param com1 second command
+	 */
+	void write_commands( uint16_t com0, uint16_t com1 )
+	{
+		com0	<<= 1;
+		com1	<<= 1;
+
+		constexpr uint8_t	lengths[]	= { 2, 2 };
+		uint8_t				v[]			= { (uint8_t)(com0 >> 8), (uint8_t)(com0 & 0xFF), (uint8_t)(com1 >> 8), (uint8_t)(com1 & 0xFF) };
+		
+		_spi.write_frames( v, v, lengths, 2 );
+	}
+
+	/** Frame burst
+	 *
+	 *	Frames are queued in one SPI transfer, CS is negated between frames. 
+	 *	Received data overwrites the buffer
+	 *
+	 * @param data pointer to data buffer, all frames packed
+	 * @param lengths array of frame lengths
+	 * @param n number of frames
+	 */
+	void txrx_frames( uint8_t *data, const uint8_t *lengths, int n )
+	{
+		_spi.write_frames( data, data, lengths, n );
+	}
 
 	/** Register write, 8 bit
 	 *
 	 * @param reg register index
 	 */
-	void write_r16( uint16_t reg );
+	void write_r16( uint16_t reg )
+	{
+		reg	<<= 1;
+
+		uint8_t	v[]	= { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF) };
+		txrx( v, sizeof( v ) );
+	}
 
 	/** Register write, 16 bit
 	 *
 	 * @param reg register index
 	 * @param val data value
 	 */
-	void write_r16( uint16_t reg, uint16_t val );
+	void write_r16( uint16_t reg, uint16_t val )
+	{
+		reg	<<= 1;
+
+		uint8_t	v[]	= { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF), (uint8_t)(val >> 8), (uint8_t)val };
+		txrx( v, sizeof( v ) );
+	}
 
 	/** Register read, 16 bit
 	 *
 	 * @param reg register index
 	 * @return data value
 	 */
-	uint16_t read_r16( uint16_t reg );
+	uint16_t read_r16( uint16_t reg )
+	{
+		reg	<<= 1;
+		reg	 |= 0x4000;
+
+		uint8_t	v[ 4 ]	= { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF), 0xFF, 0xFF };
+		txrx( v, sizeof( v ) );
+		
+		return (uint16_t)(v[ 2 ]) << 8 | v[ 3 ];
+	}
 
 	/** Register write, 24 bit
 	 *
 	 * @param reg register index
 	 * @param val data value
 	 */
-	void write_r24( uint16_t reg, uint32_t val );
+	void write_r24( uint16_t reg, uint32_t val )
+	{
+		reg	<<= 1;
+
+		uint8_t	v[]	= { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF), (uint8_t)(val >> 16), (uint8_t)(val >> 8), (uint8_t)val };
+		txrx( v, sizeof( v ) );
+	}
 
 	/** Register read, 24 bit
 	 *
 	 * @param reg register index
 	 * @return data value
 	 */
-	int32_t read_r24( uint16_t reg );
+	int32_t read_r24( uint16_t reg )
+	{
+		reg	<<= 1;
+		reg	 |= 0x4000;
+
+		uint8_t	v[]	= { (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF), 0xFF, 0xFF, 0xFF };
+		txrx( v, sizeof( v ) );
+		
+		int32_t	r0	= v[ 2 ];
+		int32_t	r1	= v[ 3 ];
+		int32_t	r2	= v[ 4 ];
+		int32_t	r	= ( (r0 << 24) | (r1 << 16) | (r2 << 8) );
+
+		return r >> 8;
+	}
 private:
 	SPI& _spi;
 };
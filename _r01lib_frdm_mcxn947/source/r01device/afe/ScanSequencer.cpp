@@ -0,0 +1,366 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"ScanSequencer.h"
+
+using	Register16	= NAFE_registers::Register16;
+
+template<class traits>
+ScanSequencer<traits>::ScanSequencer( NAFE_Base<traits>& afe_ )
+	: afe( afe_ ), n_steps( 0 ), length( 1 ), last_frame( 0 ), frame_count( 0 ),
+	  user_channels( 0 ), active_channels( 0 ), io_channels( 0 ), running( false ),
+	  sampled( 0 ), n_derived( 0 ), derived_flags( 0 )
+{
+	frame_map[ 0 ]	= 0;
+
+	for ( auto ch = 0; ch < max_steps; ch++ )
+		ch_step[ ch ]	= -1;
+}
+
+template<class traits>
+ScanSequencer<traits>::~ScanSequencer()
+{
+	stop();
+}
+
+template<class traits>
+bool ScanSequencer<traits>::compile( const step *lst, int n )
+{
+	if ( (n < 1) || (max_steps < n) )
+		return false;
+
+	uint16_t	channels	= 0;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		const int	ch	= lst[ i ].ch;
+
+		if ( (ch < 0) || (max_steps <= ch) || (channels & (0x1 << ch)) || (afe.data_rate( ch ) == 0.0) )
+			return false;
+
+		channels	|= 0x1 << ch;
+	}
+
+	n_steps		= n;
+	length		= 1;
+	io_channels	= 0;
+
+	for ( auto ch = 0; ch < max_steps; ch++ )
+		ch_step[ ch ]	= -1;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		step&	s	= list[ i ];
+
+		s	= lst[ i ];
+
+		s.oversample	= (s.oversample < 1) ? 1 : ((max_oversample < s.oversample) ? max_oversample : s.oversample);
+		s.period		= (s.period     < 1) ? 1 : ((max_period     < s.period    ) ? max_period     : s.period    );
+
+		while ( s.period & (s.period - 1) )
+			s.period	&= s.period - 1;
+
+		if ( length < s.period )
+			length	= s.period;
+
+		value[ i ]		= 0;
+		ch_step[ s.ch ]	= i;
+
+		if ( s.io )
+			io_channels	|= 0x1 << s.ch;
+	}
+
+	//	channels in every frame first, then slower ones from the heaviest.
+	//	Each slow channel takes the phase which makes the busiest frame least busy
+
+	float	load[ max_period ];
+	bool	placed[ max_steps ];
+
+	for ( auto f = 0; f < length; f++ )
+	{
+		load[ f ]		= 0.0;
+		frame_map[ f ]	= 0;
+	}
+
+	for ( auto i = 0; i < n; i++ )
+		placed[ i ]	= false;
+
+	for ( auto k = 0; k < n; k++ )
+	{
+		int		heaviest	= -1;
+		float	cost		= 0.0;
+
+		for ( auto i = 0; i < n; i++ )
+		{
+			if ( placed[ i ] )
+				continue;
+
+			const float	c	= list[ i ].oversample * afe.conversion_time[ list[ i ].ch ];
+
+			if ( (heaviest < 0) || (list[ i ].period < list[ heaviest ].period)
+				 || ((list[ i ].period == list[ heaviest ].period) && (cost < c)) )
+			{
+				heaviest	= i;
+				cost		= c;
+			}
+		}
+
+		const step&	s			= list[ heaviest ];
+		int			phase		= 0;
+		float		best_peak	= 0.0;
+
+		for ( auto p = 0; p < s.period; p++ )
+		{
+			float	peak	= 0.0;
+
+			for ( auto f = p; f < length; f += s.period )
+				peak	= (peak < load[ f ]) ? load[ f ] : peak;
+
+			if ( !p || (peak < best_peak) )
+			{
+				phase		= p;
+				best_peak	= peak;
+			}
+		}
+
+		for ( auto f = phase; f < length; f += s.period )
+		{
+			load[ f ]		+= cost;
+			frame_map[ f ]	|= 0x1 << s.ch;
+		}
+
+		placed[ heaviest ]	= true;
+	}
+
+	last_frame		= 0;
+	frame_count		= 0;
+	sampled			= 0;
+	n_derived		= 0;
+	derived_flags	= 0;
+
+	return true;
+}
+
+template<class traits>
+bool ScanSequencer<traits>::run( void )
+{
+	if ( !n_steps )
+		return false;
+
+	if ( !running )
+	{
+		user_channels	= afe.reg( Register16::CH_CONFIG4 );
+		active_channels	= user_channels;
+		running			= true;
+	}
+
+	const uint16_t	due		= frame_map[ frame_count % length ];
+	int64_t			sum[ max_steps ]	= { 0 };
+	raw_t			data[ max_steps ];
+	uint16_t		failed	= 0;
+
+	for ( auto pass = 0; ; pass++ )
+	{
+		const uint16_t	channels	= pass_channels( due & ~failed, pass );
+
+		if ( !channels )
+			break;
+
+		if ( channels != active_channels )
+		{
+			afe.reg( Register16::CH_CONFIG4, channels );
+			active_channels	= channels;
+		}
+
+		if ( !afe.sequence_read( channels, data, pass_timeout( channels ) ) )
+		{
+			failed	|= channels;	//	the pass is not used, the channels are not updated in this frame
+			continue;
+		}
+
+		for ( auto i = 0; i < n_steps; i++ )
+			if ( channels & (0x1 << list[ i ].ch) )
+				sum[ i ]	+= data[ list[ i ].ch ];
+	}
+
+	failed	|= io_steps( due & ~failed, sum );
+
+	const uint16_t	done	= due & ~failed;
+
+	for ( auto i = 0; i < n_steps; i++ )
+		if ( done & (0x1 << list[ i ].ch) )
+			value[ i ]	= (raw_t)(sum[ i ] / list[ i ].oversample);
+
+	last_frame	 = done;
+	sampled		|= done;
+	frame_count++;
+
+	evaluate();
+
+	return !failed;
+}
+
+template<class traits>
+void ScanSequencer<traits>::stop( void )
+{
+	if ( !running )
+		return;
+
+	if ( active_channels != user_channels )
+		afe.reg( Register16::CH_CONFIG4, user_channels );
+
+	running	= false;
+}
+
+template<class traits>
+float ScanSequencer<traits>::frame_time( int frame ) const
+{
+	const uint16_t	due		= frame_map[ frame ];
+	float			time	= 0.0;
+
+	for ( auto i = 0; i < n_steps; i++ )
+		if ( due & (0x1 << list[ i ].ch) )
+			time	+= list[ i ].oversample * (afe.conversion_time[ list[ i ].ch ] + (list[ i ].io ? list[ i ].io->settle : 0.0f));
+
+	return time;
+}
+
+template<class traits>
+float ScanSequencer<traits>::sample_rate( void ) const
+{
+	float	time	= 0.0;
+	int		samples	= 0;
+
+	for ( auto f = 0; f < length; f++ )
+	{
+		time	+= frame_time( f );
+
+		for ( auto i = 0; i < n_steps; i++ )
+			if ( frame_map[ f ] & (0x1 << list[ i ].ch) )
+				samples++;
+	}
+
+	return (0.0 < time) ? samples / time : 0.0;
+}
+
+template<class traits>
+int ScanSequencer<traits>::derive( const derived_channel& d )
+{
+	if ( (max_derived <= n_derived) || (d.n < 1) || (max_terms < d.n) )
+		return -1;
+
+	if ( (d.type == Derivation::RATIO) && (d.n < 2) )
+		return -1;
+
+	uint16_t	inputs	= 0;
+
+	for ( auto i = 0; i < d.n; i++ )
+	{
+		if ( (d.ch[ i ] < 0) || (max_steps <= d.ch[ i ]) || (ch_step[ d.ch[ i ] ] < 0) )
+			return -1;
+
+		inputs	|= 0x1 << d.ch[ i ];
+	}
+
+	derivation[ n_derived ]		= d;
+	derived_inputs[ n_derived ]	= inputs;
+	derived_value[ n_derived ]	= 0.0;
+
+	return n_derived++;
+}
+
+template<class traits>
+void ScanSequencer<traits>::evaluate( void )
+{
+	derived_flags	= 0;
+
+	for ( auto i = 0; i < n_derived; i++ )
+	{
+		const uint16_t	inputs	= derived_inputs[ i ];
+
+		if ( !(last_frame & inputs) || ((sampled & inputs) != inputs) )
+			continue;
+
+		const derived_channel&	d		= derivation[ i ];
+		const int				terms	= (d.type == Derivation::RATIO) ? d.n - 1 : d.n;
+		double					y		= d.offset;
+
+		for ( auto t = 0; t < terms; t++ )
+			y	+= d.k[ t ] * value[ ch_step[ d.ch[ t ] ] ] * afe.coeff_uV[ d.ch[ t ] ];
+
+		if ( d.type == Derivation::RATIO )
+		{
+			const int		last	= d.n - 1;
+			const double	den		= d.k[ last ] * value[ ch_step[ d.ch[ last ] ] ] * afe.coeff_uV[ d.ch[ last ] ];
+
+			if ( den == 0.0 )
+				continue;
+
+			y	/= den;
+		}
+
+		derived_value[ i ]	 = y;
+		derived_flags		|= 0x1 << i;
+	}
+}
+
+template<class traits>
+uint16_t ScanSequencer<traits>::pass_channels( uint16_t due, int pass ) const
+{
+	uint16_t	channels	= 0;
+
+	for ( auto i = 0; i < n_steps; i++ )
+		if ( (due & (0x1 << list[ i ].ch)) && (pass < list[ i ].oversample) )
+			channels	|= 0x1 << list[ i ].ch;
+
+	return channels & ~io_channels;
+}
+
+template<class traits>
+uint16_t ScanSequencer<traits>::io_steps( uint16_t due, int64_t *sum )
+{
+	uint16_t	failed	= 0;
+	raw_t		data;
+
+	for ( auto i = 0; i < n_steps; i++ )
+	{
+		const step&	s	= list[ i ];
+
+		if ( !s.io || !(due & (0x1 << s.ch)) )
+			continue;
+
+		for ( auto k = 0; k < s.oversample; k++ )
+		{
+			if ( !afe.io_read( s.ch, *s.io, data, pass_timeout( 0x1 << s.ch ) ) )
+			{
+				failed	|= 0x1 << s.ch;	//	the step is not updated in this frame
+				break;
+			}
+
+			sum[ i ]	+= data;
+		}
+	}
+
+	return failed;
+}
+
+template<class traits>
+float ScanSequencer<traits>::pass_timeout( uint16_t channels ) const
+{
+	constexpr float	timeout_margin	= 2.0;
+	constexpr float	timeout_minimum	= 0.001;
+	float			time			= 0.0;
+
+	for ( auto ch = 0; ch < max_steps; ch++ )
+		if ( channels & (0x1 << ch) )
+			time	+= afe.conversion_time[ ch ];
+
+	return time * timeout_margin + timeout_minimum;
+}
+
+template class ScanSequencer<NAFE13388_traits>;
@@ -0,0 +1,256 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Scan sequencer for logical channel lists
+ *
+ *	A scan list is an ordered list of logical channels with oversampling count and period.
+ *	Channels don't need to be contiguous, disabled channels in the middle are just not listed.
+ *	compile() makes a frame schedule: which channels are converted in each frame.
+ *	Slow channels are spread over the frames to even out the frame time.
+ *
+ *	A frame is done by multi-channel single conversions (CMD_MS).
+ *	The channels due in the frame are enabled in CH_CONFIG4 and converted in one command,
+ *	so no per-channel start command and software delay are needed.
+ *	Oversampling is done by repeating CMD_MS with the channels which need more conversions.
+ *	CH_CONFIG4 is written only when the set of channels changes.
+ *
+ *	A step can have an I/O setting (GPO and excitation) for sensor switching.
+ *	Such step is converted by itself with single conversion. The I/O change, channel pointer and start command
+ *	are sent in one SPI burst (NAFE_Base::io_read()), settling is done by CH_DELAY or io_setting.settle.
+ *
+ *	Derived channels (difference, sum, ratio or linear combination of logical channels) are
+ *	evaluated from the frame samples at the end of run(). No extra conversion is done for them.
+ *
+ *  Example:
+ *  @code
+ *  const ScanSequencer<NAFE13388_traits>::step	list[]	= {
+ *  	//	ch, oversample, period
+ *  	{   0,          1,      1 },	//	every frame
+ *  	{   3,          4,      1 },	//	every frame, average of 4
+ *  	{   7,          1,      8 },	//	every 8th frame
+ *  };
+ *
+ *  ScanSequencer	seq( afe );
+ *  seq.compile( list, 3 );
+ *
+ *  while ( true )
+ *  {
+ *  	seq.run();
+ *
+ *  	for ( auto i = 0; i < seq.steps(); i++ )
+ *  		if ( seq.updated( i ) )
+ *  			printf( "ch%d: %ld\r\n", seq.channel( i ), seq.data( i ) );
+ *  }
+ *
+ *  seq.stop();	//	CH_CONFIG4 is restored
+ *  @endcode
+ *
+ *  Sensor switching by AFE GPO:
+ *  @code
+ *  constexpr NAFE13388_Base::io_setting	sensor_a	= { 0x0040, 0x0040, -1, 0.0 };
+ *  constexpr NAFE13388_Base::io_setting	sensor_b	= { 0x0040, 0x0000, -1, 0.0 };
+ *
+ *  const ScanSequencer<NAFE13388_traits>::step	list[]	= {
+ *  	{   0,          1,      1 },
+ *  	{   1,          1,      1, &sensor_a },	//	ch1 with GPO set
+ *  	{   2,          1,      1, &sensor_b },	//	ch2 with GPO cleared
+ *  };
+ *  @endcode
+ *
+ *  Derived channels:
+ *  @code
+ *  seq.compile( list, 3 );
+ *
+ *  auto	diff	= seq.derive( ScanSequencer<NAFE13388_traits>::difference( 0, 3 ) );	//	ch0 - ch3 in µV
+ *  auto	ratio	= seq.derive( ScanSequencer<NAFE13388_traits>::ratio( 0, 7 ) );		//	ch0 / ch7
+ *
+ *  seq.run();
+ *
+ *  if ( seq.derived_updated( diff ) )
+ *  	printf( "%lf µV\r\n", seq.derived( diff ) );
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_SCAN_SEQUENCER_H
+#define ARDUINO_AFE_SCAN_SEQUENCER_H
+
+#include	"AFE_NXP.h"
+
+/** ScanSequencer class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ */
+template<class traits>
+class ScanSequencer
+{
+public:
+	using raw_t	= AFE_base::raw_t;
+
+	constexpr static int	max_steps		= traits::logical_channels;
+	constexpr static int	max_period		= 64;
+	constexpr static int	max_oversample	= 256;
+	constexpr static int	max_derived		= 8;
+	constexpr static int	max_terms		= 4;
+
+	/** Scan list entry */
+	typedef struct	_step	{
+		int		ch;			//	logical channel number
+		int		oversample;	//	conversions averaged for a sample (1 ~ max_oversample)
+		int		period;		//	sampled once in this number of frames (1 ~ max_period), rounded down to power of 2
+		const typename NAFE_Base<traits>::io_setting	*io;	//	I/O setting before conversion, nullptr for none
+	} step;
+
+	/** Derived channel types */
+	enum class Derivation : uint8_t {
+		LINEAR,		//	sum of k[i] * ch[i] + offset, in µV
+		RATIO,		//	(sum of k[i] * ch[i] for i < n - 1 + offset) / (k[n - 1] * ch[n - 1])
+	};
+
+	/** Derived channel definition */
+	typedef struct	_derived_channel	{
+		Derivation	type;
+		int			n;					//	number of terms (1 ~ max_terms, 2 or more for RATIO)
+		int			ch[ max_terms ];	//	logical channels, need to be in the scan list
+		double		k[ max_terms ];		//	coefficients
+		double		offset;
+	} derived_channel;
+
+	/** ch_a - ch_b in µV */
+	constexpr static derived_channel	difference( int ch_a, int ch_b )
+	{
+		return { Derivation::LINEAR, 2, { ch_a, ch_b }, { 1.0, -1.0 }, 0.0 };
+	}
+
+	/** ch_a + ch_b in µV */
+	constexpr static derived_channel	sum( int ch_a, int ch_b )
+	{
+		return { Derivation::LINEAR, 2, { ch_a, ch_b }, { 1.0, 1.0 }, 0.0 };
+	}
+
+	/** scale * ch_a / ch_b, for ratiometric measurement */
+	constexpr static derived_channel	ratio( int ch_a, int ch_b, double scale = 1.0 )
+	{
+		return { Derivation::RATIO, 2, { ch_a, ch_b }, { scale, 1.0 }, 0.0 };
+	}
+
+	/** Create a ScanSequencer instance
+	 *
+	 * @param afe_ AFE instance
+	 */
+	ScanSequencer( NAFE_Base<traits>& afe_ );
+
+	/** Destructor */
+	virtual ~ScanSequencer();
+
+	/** Compile scan list into frame schedule
+	 *
+	 *	Logical channels need to be configured by logical_ch_config() before this call.
+	 *
+	 * @param list scan list
+	 * @param n number of entries (1 ~ max_steps)
+	 * @return false if the list has unconfigured or duplicated channel. Previous schedule is kept in that case
+	 */
+	bool	compile( const step *list, int n );
+
+	/** Run a frame
+	 *
+	 *	If a conversion timed-out, the channels in it are not updated in this frame. 
+	 *	
+	 * @return false if a conversion timed-out
+	 */
+	bool	run( void );
+
+	/** Stop scanning and restore CH_CONFIG4 as it was before first run() */
+	void	stop( void );
+
+	/** Number of entries in scan list */
+	int		steps( void ) const	{ return n_steps; }
+
+	/** Logical channel of an entry */
+	int		channel( int i ) const	{ return list[ i ].ch; }
+
+	/** Check an entry is sampled in last frame */
+	bool	updated( int i ) const	{ return last_frame & (0x1 << list[ i ].ch); }
+
+	/** Sample of an entry, average of oversampled conversions */
+	raw_t	data( int i ) const	{ return value[ i ]; }
+
+	/** Number of frames done */
+	uint32_t	frames( void ) const	{ return frame_count; }
+
+	/** Schedule length in frames. The schedule repeats in this cycle */
+	int		schedule_length( void ) const	{ return length; }
+
+	/** Logical channels converted in a frame
+	 *
+	 * @param frame frame number in schedule (0 ~ schedule_length() - 1)
+	 * @return bitmap of logical channels
+	 */
+	uint16_t	schedule( int frame ) const	{ return frame_map[ frame ]; }
+
+	/** Estimated conversion time of a frame in seconds, from conversion_time[] */
+	float	frame_time( int frame ) const;
+
+	/** Estimated samples per second over the schedule cycle */
+	float	sample_rate( void ) const;
+
+	/** Add a derived channel
+	 *
+	 *	Derived channels are cleared by compile(). Add them after compile().
+	 *
+	 * @param d definition
+	 * @return index of the derived channel, -1 if the definition is invalid or no room
+	 */
+	int		derive( const derived_channel& d );
+
+	/** Remove all derived channels */
+	void	derive_clear( void )	{ n_derived = 0; derived_flags = 0; }
+
+	/** Number of derived channels */
+	int		derived_channels( void ) const	{ return n_derived; }
+
+	/** Check a derived channel is evaluated in last frame
+	 *
+	 *	It is evaluated when one or more of its inputs are sampled in the frame
+	 *	and all inputs have been sampled since compile()
+	 */
+	bool	derived_updated( int i ) const	{ return derived_flags & (0x1 << i); }
+
+	/** Value of a derived channel */
+	double	derived( int i ) const	{ return derived_value[ i ]; }
+
+private:
+	uint16_t	pass_channels( uint16_t due, int pass ) const;
+	float		pass_timeout( uint16_t channels ) const;
+	uint16_t	io_steps( uint16_t due, int64_t *sum );
+	void		evaluate( void );
+
+	NAFE_Base<traits>&	afe;
+	step			list[ max_steps ];
+	int				n_steps;
+	int				length;
+	uint16_t		frame_map[ max_period ];
+	raw_t			value[ max_steps ];
+	uint16_t		last_frame;
+	uint32_t		frame_count;
+	uint16_t		user_channels;
+	uint16_t		active_channels;
+	uint16_t		io_channels;
+	bool			running;
+
+	int8_t			ch_step[ max_steps ];
+	uint16_t		sampled;
+	derived_channel	derivation[ max_derived ];
+	uint16_t		derived_inputs[ max_derived ];
+	double			derived_value[ max_derived ];
+	int				n_derived;
+	uint16_t		derived_flags;
+};
+
+extern template class ScanSequencer<NAFE13388_traits>;
+
+#endif //	ARDUINO_AFE_SCAN_SEQUENCER_H
@@ -0,0 +1,278 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"SpectrumAnalyzer.h"
+#include	<math.h>
+#include	<algorithm>
+
+constexpr float	pi	= 3.14159265358979f;
+
+template<class traits>
+SpectrumAnalyzer_base<traits>::SpectrumAnalyzer_base( NAFE_Base<traits>& afe_, int ch_, float *data_, float *twiddle_, float *power_, int n_ )
+	: afe( afe_ ), ch( ch_ ), data( data_ ), twiddle( twiddle_ ), power( power_ ), n( n_ ),
+	  count( 0 ), first_time( 0 ), last_time( 0 ), window_power( 0.0 ), last{}
+{
+	spur_threshold( 13.0 );
+}
+
+template<class traits>
+SpectrumAnalyzer_base<traits>::~SpectrumAnalyzer_base()
+{
+}
+
+template<class traits>
+void SpectrumAnalyzer_base<traits>::init( void )
+{
+	//	W_n^k = exp( -j 2 pi k / n ) for k = 0 ~ n / 2.
+	//	Butterflies of the n / 2 point complex FFT use the even ones, the real FFT split uses all
+
+	for ( auto k = 0; k <= n / 2; k++ )
+	{
+		twiddle[ k * 2     ]	=  cosf( 2 * pi * k / n );
+		twiddle[ k * 2 + 1 ]	= -sinf( 2 * pi * k / n );
+	}
+
+	window_power	= 0.0;
+
+	for ( auto i = 0; i < n; i++ )
+		window_power	+= window( i ) * window( i );
+}
+
+template<class traits>
+void SpectrumAnalyzer_base<traits>::spur_threshold( float ratio_dB )
+{
+	threshold	= powf( 10.0, ratio_dB / 10.0 );
+}
+
+template<class traits>
+bool SpectrumAnalyzer_base<traits>::feed( raw_t s, uint32_t timestamp )
+{
+	if ( n <= count )
+		count	= 0;
+
+	if ( !count )
+		first_time	= timestamp;
+
+	last_time			= timestamp;
+	data[ count++ ]		= (float)(s * afe.coeff_uV[ ch ]);
+
+	return n <= count;
+}
+
+template<class traits>
+bool SpectrumAnalyzer_base<traits>::acquire( float delay )
+{
+	const raw_t		s	= afe.template read<raw_t>( ch, delay );
+
+	if ( !feed( s, cycle_counter() ) )
+		return false;
+
+	analyze();
+
+	return true;
+}
+
+template<class traits>
+const typename SpectrumAnalyzer_base<traits>::spectrum_result& SpectrumAnalyzer_base<traits>::analyze( float sample_rate )
+{
+	const uint32_t	start	= cycle_counter();
+
+	if ( sample_rate <= 0.0 )
+	{
+		if ( first_time != last_time )
+			sample_rate	= (float)(n - 1) * cycle_frequency() / (uint32_t)(last_time - first_time);
+		else
+			sample_rate	= afe.data_rate( ch );
+	}
+
+	float	mean	= 0.0;
+
+	for ( auto i = 0; i < n; i++ )
+		mean	+= data[ i ];
+
+	mean	/= n;
+
+	for ( auto i = 0; i < n; i++ )
+		data[ i ]	= (data[ i ] - mean) * window( i );
+
+	fft();
+	spectrum( sample_rate );
+
+	//	power of the bins is chi-squared with 2 degrees of freedom: mean = median / ln( 2 ).
+	//	data[] is free after spectrum() and used as work area
+
+	const int	m		= n / 2 - dc_bins;
+	float		*work	= data;
+	float		total	= 0.0;
+
+	for ( auto k = 0; k < m; k++ )
+	{
+		work[ k ]	 = power[ k + dc_bins ];
+		total		+= work[ k ];
+	}
+
+	std::nth_element( work, work + m / 2, work + m );
+
+	const float	floor	= work[ m / 2 ] / logf( 2.0 );
+
+	last.sample_rate	= sample_rate;
+	last.resolution		= sample_rate / n;
+	last.dc				= mean;
+	last.rms			= sqrtf( total * last.resolution );
+	last.noise_density	= sqrtf( floor );
+
+	find_spurs( floor );
+
+	last.analysis_time	= (float)(cycle_counter() - start) / cycle_frequency();
+	count				= 0;
+
+	return last;
+}
+
+template<class traits>
+inline float SpectrumAnalyzer_base<traits>::window( int i ) const
+{
+	//	Hann, cos( 2 pi i / n ) taken from the twiddle table
+
+	const int	k	= (i <= n / 2) ? i : n - i;
+
+	return 0.5f - 0.5f * twiddle[ k * 2 ];
+}
+
+template<class traits>
+void SpectrumAnalyzer_base<traits>::fft( void )
+{
+	//	n real samples are taken as n / 2 complex samples ( even + j odd ) in place
+
+	const int	m	= n / 2;
+	float		*z	= data;
+
+	for ( int i = 1, j = 0; i < m; i++ )
+	{
+		int	bit	= m >> 1;
+
+		for ( ; j & bit; bit >>= 1 )
+			j	^= bit;
+
+		j	^= bit;
+
+		if ( i < j )
+		{
+			std::swap( z[ i * 2     ], z[ j * 2     ] );
+			std::swap( z[ i * 2 + 1 ], z[ j * 2 + 1 ] );
+		}
+	}
+
+	for ( auto len = 2; len <= m; len <<= 1 )
+	{
+		const int	half	= len / 2;
+		const int	stride	= n / len;
+
+		for ( auto k = 0; k < half; k++ )
+		{
+			const float	wr	= twiddle[ k * stride * 2     ];
+			const float	wi	= twiddle[ k * stride * 2 + 1 ];
+
+			for ( auto a = k; a < m; a += len )
+			{
+				const int	b	= a + half;
+				const float	tr	= z[ b * 2 ] * wr - z[ b * 2 + 1 ] * wi;
+				const float	ti	= z[ b * 2 ] * wi + z[ b * 2 + 1 ] * wr;
+
+				z[ b * 2     ]	 = z[ a * 2     ] - tr;
+				z[ b * 2 + 1 ]	 = z[ a * 2 + 1 ] - ti;
+				z[ a * 2     ]	+= tr;
+				z[ a * 2 + 1 ]	+= ti;
+			}
+		}
+	}
+}
+
+template<class traits>
+void SpectrumAnalyzer_base<traits>::spectrum( float sample_rate )
+{
+	//	split the n / 2 point complex FFT into the real FFT bins and scale into one-sided PSD
+
+	const int	m		= n / 2;
+	const float	*z		= data;
+	const float	scale	= 1.0f / (sample_rate * window_power);
+
+	power[ 0 ]	= (z[ 0 ] + z[ 1 ]) * (z[ 0 ] + z[ 1 ]) * scale;
+	power[ m ]	= (z[ 0 ] - z[ 1 ]) * (z[ 0 ] - z[ 1 ]) * scale;
+
+	for ( auto k = 1; k < m; k++ )
+	{
+		const float	ar	= z[ k * 2 ],		ai	=  z[ k * 2 + 1 ];
+		const float	br	= z[ (m - k) * 2 ],	bi	= -z[ (m - k) * 2 + 1 ];
+
+		const float	er	= (ar + br) * 0.5f,	ei	= (ai + bi) * 0.5f;	//	even part
+		const float	or_	= (ai - bi) * 0.5f,	oi	= (br - ar) * 0.5f;	//	odd part
+
+		const float	wr	= twiddle[ k * 2 ],	wi	= twiddle[ k * 2 + 1 ];
+		const float	xr	= er + or_ * wr - oi * wi;
+		const float	xi	= ei + or_ * wi + oi * wr;
+
+		power[ k ]	= (xr * xr + xi * xi) * 2.0f * scale;
+	}
+}
+
+template<class traits>
+void SpectrumAnalyzer_base<traits>::find_spurs( float floor )
+{
+	const int	m	= n / 2;
+	spur		*s	= last.spurs;
+	float		peak_power[ max_spurs ];
+
+	last.n_spurs	= 0;
+
+	for ( auto k = dc_bins; k < m; k++ )
+	{
+		if ( (power[ k ] < threshold * floor) || (power[ k ] <= power[ k - 1 ]) || (power[ k ] < power[ k + 1 ]) )
+			continue;
+
+		const int	from	= std::max( k - spur_half_width, 0 );
+		const int	to		= std::min( k + spur_half_width, m );
+		float		sum		= 0.0;
+		float		moment	= 0.0;
+
+		for ( auto i = from; i <= to; i++ )
+		{
+			sum		+= power[ i ];
+			moment	+= power[ i ] * i;
+		}
+
+		const float	p	= (sum - floor * (to - from + 1)) * last.resolution;
+
+		//	keep in descending order
+
+		int	pos	= last.n_spurs;
+
+		while ( pos && (peak_power[ pos - 1 ] < p) )
+			pos--;
+
+		if ( max_spurs <= pos )
+			continue;
+
+		const int	last_index	= std::min( last.n_spurs, max_spurs - 1 );
+
+		for ( auto i = last_index; pos < i; i-- )
+		{
+			s[ i ]			= s[ i - 1 ];
+			peak_power[ i ]	= peak_power[ i - 1 ];
+		}
+
+		s[ pos ].frequency	= moment / sum * last.resolution;
+		s[ pos ].amplitude	= sqrtf( std::max( p, 0.0f ) );
+		peak_power[ pos ]	= p;
+
+		if ( last.n_spurs < max_spurs )
+			last.n_spurs++;
+	}
+}
+
+template class SpectrumAnalyzer_base<NAFE13388_traits>;
@@ -0,0 +1,189 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Spectral noise analysis of a logical channel
+ *
+ *	A block of 2^n samples is taken from a logical channel, Hann windowed and transformed by a float real FFT.
+ *	The result is one-sided power spectral density in µV^2/Hz, noise density and the dominant spurs.
+ *	Noise floor is estimated from median of the bins, so it is not pulled up by mains pickup or other spurs.
+ *	All storage is in the instance, no heap is used.
+ *
+ *  Example:
+ *  @code
+ *  SpectrumAnalyzer<NAFE13388_traits, 1024>	sa( afe, 0 );	//	logical channel 0
+ *
+ *  while ( true )
+ *  {
+ *  	if ( sa.acquire() )
+ *  	{
+ *  		auto	r	= sa.result();
+ *
+ *  		printf( "%8.3f µV/√Hz, %8.3f µVrms\r\n", r.noise_density, r.rms );
+ *
+ *  		for ( auto i = 0; i < r.n_spurs; i++ )
+ *  			printf( "  %8.2f Hz : %8.3f µVrms\r\n", r.spurs[ i ].frequency, r.spurs[ i ].amplitude );
+ *  	}
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_SPECTRUM_ANALYZER_H
+#define ARDUINO_AFE_SPECTRUM_ANALYZER_H
+
+#include	"AFE_NXP.h"
+
+/** SpectrumAnalyzer_base class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ */
+template<class traits>
+class SpectrumAnalyzer_base
+{
+public:
+	using raw_t	= AFE_base::raw_t;
+
+	constexpr static int	max_spurs			= 8;
+
+	/** Bins skipped from the noise and spur search (DC and its window leakage) */
+	constexpr static int	dc_bins				= 3;
+
+	/** Bins taken on each side of a spur peak to measure its power */
+	constexpr static int	spur_half_width		= 2;
+
+	typedef struct	_spur {
+		float	frequency;		//	Hz
+		float	amplitude;		//	µV rms
+	} spur;
+
+	typedef struct	_spectrum_result {
+		float	sample_rate;	//	Hz
+		float	resolution;		//	bin width in Hz
+		float	dc;				//	block mean in µV
+		float	rms;			//	AC rms in µV, DC bins excluded
+		float	noise_density;	//	µV/√Hz, spurs excluded
+		float	analysis_time;	//	seconds spent in analyze()
+		int		n_spurs;
+		spur	spurs[ max_spurs ];	//	in descending order of amplitude
+	} spectrum_result;
+
+	/** Destructor */
+	virtual ~SpectrumAnalyzer_base();
+
+	/** Block size in samples */
+	int		size( void ) const	{ return n; }
+
+	/** Number of PSD bins (size() / 2 + 1) */
+	int		bins( void ) const	{ return n / 2 + 1; }
+
+	/** Spur detection threshold
+	 *
+	 * @param ratio_dB a local peak this much above the noise floor is reported as a spur
+	 */
+	void	spur_threshold( float ratio_dB );
+
+	/** Feed a sample
+	 *
+	 *	Use this if the samples are acquired outside of this class.
+	 *	Sample is scaled by coeff_uV of the channel.
+	 *
+	 * @param s ADC readout
+	 * @param timestamp cycle_counter() value of the sample, 0 if not available
+	 * @return true when the block is filled
+	 */
+	bool	feed( raw_t s, uint32_t timestamp = 0 );
+
+	/** Acquire a sample from AFE and feed it. Block is analyzed when it is filled
+	 *
+	 * @param delay read delay, see AFE_base::read()
+	 * @return true when a new result is available
+	 */
+	bool	acquire( float delay = AFE_base::auto_delay );
+
+	/** Analyze the filled block
+	 *
+	 * @param sample_rate sample rate in Hz. If 0, measured from timestamps or data_rate() of the channel
+	 * @return result
+	 */
+	const spectrum_result&	analyze( float sample_rate = 0.0 );
+
+	/** Last result */
+	const spectrum_result&	result( void ) const	{ return last; }
+
+	/** Power spectral density of a bin
+	 *
+	 * @param k bin index (0 ~ bins() - 1)
+	 * @return µV^2/Hz
+	 */
+	float	psd( int k ) const	{ return power[ k ]; }
+
+	/** Frequency of a bin in Hz */
+	float	frequency( int k ) const	{ return k * last.resolution; }
+
+protected:
+	/** Buffers are given by derived class
+	 *
+	 * @param data_ n floats for samples and FFT work area
+	 * @param twiddle_ n + 2 floats for twiddle factors
+	 * @param power_ n / 2 + 1 floats for PSD
+	 * @param n_ block size, power of 2 (8 or more)
+	 */
+	SpectrumAnalyzer_base( NAFE_Base<traits>& afe_, int ch_, float *data_, float *twiddle_, float *power_, int n_ );
+
+	/** Prepare twiddle factors. Called from derived class constructor after the buffers are ready */
+	void	init( void );
+
+private:
+	float	window( int i ) const;
+	void	fft( void );
+	void	spectrum( float sample_rate );
+	void	find_spurs( float floor );
+
+	NAFE_Base<traits>&	afe;
+	int				ch;
+	float			*data;
+	float			*twiddle;
+	float			*power;
+	int				n;
+	int				count;
+	uint32_t		first_time;
+	uint32_t		last_time;
+	float			window_power;
+	float			threshold;
+	spectrum_result	last;
+};
+
+/** SpectrumAnalyzer class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ * @tparam N block size in samples, power of 2
+ */
+template<class traits, int N>
+class SpectrumAnalyzer : public SpectrumAnalyzer_base<traits>
+{
+	static_assert( (8 <= N) && !(N & (N - 1)), "block size must be power of 2" );
+
+public:
+	/** Create a SpectrumAnalyzer instance
+	 *
+	 * @param afe_ AFE instance
+	 * @param ch_ logical channel number
+	 */
+	SpectrumAnalyzer( NAFE_Base<traits>& afe_, int ch_ )
+		: SpectrumAnalyzer_base<traits>( afe_, ch_, data_buffer, twiddle_buffer, power_buffer, N )
+	{
+		this->init();
+	}
+
+private:
+	float	data_buffer[ N ];
+	float	twiddle_buffer[ N + 2 ];
+	float	power_buffer[ N / 2 + 1 ];
+};
+
+extern template class SpectrumAnalyzer_base<NAFE13388_traits>;
+
+#endif //	ARDUINO_AFE_SPECTRUM_ANALYZER_H
@@ -0,0 +1,127 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"UnitConverter.h"
+
+template<class traits>
+UnitConverter<traits>::UnitConverter( NAFE_Base<traits>& afe_ ) : afe( afe_ )
+{
+	for ( auto ch = 0; ch < channels; ch++ )
+		unit( ch, Unit::MICROVOLT );
+}
+
+template<class traits>
+UnitConverter<traits>::~UnitConverter()
+{
+}
+
+template<class traits>
+void UnitConverter<traits>::unit( int ch, Unit u )
+{
+	linear( ch, 1.0, 0.0, u );
+}
+
+template<class traits>
+void UnitConverter<traits>::linear( int ch, double gain, double offset, Unit u )
+{
+	const double	c[]	= { offset, gain };
+
+	polynomial( ch, c, 1, u );
+}
+
+template<class traits>
+bool UnitConverter<traits>::polynomial( int ch, const double *c, int order, Unit u )
+{
+	if ( (order < 0) || (max_order < order) )
+		return false;
+
+	for ( auto i = 0; i <= max_order; i++ )
+		tf[ ch ].c[ i ]	= (i <= order) ? c[ i ] : 0.0;
+
+	tf[ ch ].order	= order;
+	tf[ ch ].base	= u;
+
+	return true;
+}
+
+template<class traits>
+void UnitConverter<traits>::convert( const raw_t *in, float *out, const int *chs, int n_ch, int n_samples, Layout layout ) const
+{
+	//	channel by channel, so the coefficients stay constant in the inner loop
+
+	for ( auto c = 0; c < n_ch; c++ )
+	{
+		if ( layout == Layout::SAMPLE_MAJOR )
+			kernel( chs[ c ], in + c, n_ch, out + c, n_ch, n_samples );
+		else
+			kernel( chs[ c ], in + c, n_ch, out + c * n_samples, 1, n_samples );
+	}
+}
+
+template<class traits>
+void UnitConverter<traits>::convert( int ch, const raw_t *in, float *out, int n ) const
+{
+	kernel( ch, in, 1, out, 1, n );
+}
+
+template<class traits>
+int UnitConverter<traits>::compose( int ch, float *k ) const
+{
+	//	v = raw * m, output = sum of c[ i ] * v^i = sum of (c[ i ] * m^i) * raw^i
+
+	constexpr double	unit_scale[]	= { 1.0, 1e-3, 1e-6 };
+
+	const transform&	t	= tf[ ch ];
+	const double		m	= afe.coeff_uV[ ch ] * unit_scale[ static_cast<int>( t.base ) ];
+	double				mi	= 1.0;
+
+	for ( auto i = 0; i <= t.order; i++ )
+	{
+		k[ i ]	 = (float)(t.c[ i ] * mi);
+		mi		*= m;
+	}
+
+	return t.order;
+}
+
+template<class traits>
+void UnitConverter<traits>::kernel( int ch, const raw_t *in, int in_stride, float *out, int out_stride, int n ) const
+{
+	float		k[ max_order + 1 ];
+	const int	order	= compose( ch, k );
+
+	switch ( order )
+	{
+		case 0:
+			for ( auto i = 0; i < n; i++ )
+				out[ i * out_stride ]	= k[ 0 ];
+			break;
+		case 1:
+			{
+				const float	k0	= k[ 0 ], k1 = k[ 1 ];
+
+				for ( auto i = 0; i < n; i++ )
+					out[ i * out_stride ]	= (float)in[ i * in_stride ] * k1 + k0;
+			}
+			break;
+		default:
+			for ( auto i = 0; i < n; i++ )
+			{
+				const float	x	= (float)in[ i * in_stride ];
+				float		y	= k[ order ];
+
+				for ( auto j = order - 1; 0 <= j; j-- )
+					y	= y * x + k[ j ];
+
+				out[ i * out_stride ]	= y;
+			}
+			break;
+	}
+}
+
+template class UnitConverter<NAFE13388_traits>;
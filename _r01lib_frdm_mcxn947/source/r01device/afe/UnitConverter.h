@@ -0,0 +1,132 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Block unit conversion of ADC readouts
+ *
+ *	Each logical channel has a transform: µV, mV, V or a user-defined linear/polynomial function of them.
+ *	At conversion, the transform is composed with coeff_uV into a polynomial of the raw value,
+ *	then the whole block of the channel is converted in one loop without per-sample dispatch.
+ *	Output is float and can be channel-major or sample-major.
+ *
+ *  Example:
+ *  @code
+ *  UnitConverter	conv( afe );
+ *
+ *  conv.unit( 0, UnitConverter<NAFE13388_traits>::Unit::VOLT );
+ *  conv.linear( 1, 0.25, -1000.0 );	//	0.25 * µV - 1000
+ *
+ *  const int	chs[]	= { 0, 1 };
+ *  raw_t		in[ 2 * 100 ];			//	100 frames of ch0 and ch1, sample-major
+ *  float		out[ 2 * 100 ];
+ *
+ *  conv.convert( in, out, chs, 2, 100, UnitConverter<NAFE13388_traits>::Layout::CHANNEL_MAJOR );	//	out[ 0 ~ 99 ] for ch0, out[ 100 ~ 199 ] for ch1
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_UNIT_CONVERTER_H
+#define ARDUINO_AFE_UNIT_CONVERTER_H
+
+#include	"AFE_NXP.h"
+
+/** UnitConverter class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ */
+template<class traits>
+class UnitConverter
+{
+public:
+	using raw_t	= AFE_base::raw_t;
+
+	constexpr static int	channels	= traits::logical_channels;
+	constexpr static int	max_order	= 3;
+
+	/** Base units */
+	enum class Unit : uint8_t {
+		MICROVOLT,
+		MILLIVOLT,
+		VOLT,
+	};
+
+	/** Output layouts */
+	enum class Layout : uint8_t {
+		SAMPLE_MAJOR,	//	out[ sample * n_ch + channel ], same as input
+		CHANNEL_MAJOR,	//	out[ channel * n_samples + sample ]
+	};
+
+	/** Create an UnitConverter instance. All channels are set to µV
+	 *
+	 * @param afe_ AFE instance
+	 */
+	UnitConverter( NAFE_Base<traits>& afe_ );
+
+	/** Destructor */
+	virtual ~UnitConverter();
+
+	/** Convert into base unit
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param u unit
+	 */
+	void	unit( int ch, Unit u );
+
+	/** Linear transform
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param gain output = gain * v + offset, v in base unit
+	 * @param offset output = gain * v + offset, v in base unit
+	 * @param u base unit
+	 */
+	void	linear( int ch, double gain, double offset, Unit u = Unit::MICROVOLT );
+
+	/** Polynomial transform
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param c coefficients, output = c[ 0 ] + c[ 1 ] * v + c[ 2 ] * v^2 + ..., v in base unit
+	 * @param order polynomial order (0 ~ max_order)
+	 * @param u base unit
+	 * @return false if the order is out of range
+	 */
+	bool	polynomial( int ch, const double *c, int order, Unit u = Unit::MICROVOLT );
+
+	/** Convert a block of frames
+	 *
+	 * @param in raw readouts, sample-major: in[ sample * n_ch + channel ]
+	 * @param out output buffer, n_ch * n_samples floats
+	 * @param chs logical channel numbers for each column of input
+	 * @param n_ch number of channels in a frame
+	 * @param n_samples number of frames
+	 * @param layout output layout
+	 */
+	void	convert( const raw_t *in, float *out, const int *chs, int n_ch, int n_samples, Layout layout = Layout::SAMPLE_MAJOR ) const;
+
+	/** Convert a block of single channel
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param in raw readouts
+	 * @param out output buffer
+	 * @param n number of samples
+	 */
+	void	convert( int ch, const raw_t *in, float *out, int n ) const;
+
+private:
+	int		compose( int ch, float *k ) const;
+	void	kernel( int ch, const raw_t *in, int in_stride, float *out, int out_stride, int n ) const;
+
+	typedef struct	_transform	{
+		double	c[ max_order + 1 ];
+		int		order;
+		Unit	base;
+	} transform;
+
+	NAFE_Base<traits>&	afe;
+	transform		tf[ channels ];
+};
+
+extern template class UnitConverter<NAFE13388_traits>;
+
+#endif //	ARDUINO_AFE_UNIT_CONVERTER_H
@@ -0,0 +1,217 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Triggered waveform capture
+ *
+ *	Samples of a logical channel are kept in a circular buffer. 
+ *	When a trigger condition (level and slope) is met, samples of pre/post-trigger window are frozen. 
+ *	All storage is in the instance, no heap is used. 
+ *
+ *  Example:
+ *  @code
+ *  WaveCapture<NAFE13388_traits, 256>	cap( afe, 0 );	//	logical channel 0
+ *  
+ *  cap.trigger( 100000, WaveCapture<NAFE13388_traits, 256>::RISING );
+ *  cap.window( 64 );	//	64 pre-trigger samples, 192 post-trigger samples
+ *  cap.arm();
+ *  
+ *  while ( !cap.acquire() )
+ *  	;
+ *  
+ *  for ( auto i = 0; i < cap.length(); i++ )
+ *  	printf( "%d, %ld\r\n", i - cap.pre_trigger(), cap.sample( i ) );
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_WAVE_CAPTURE_H
+#define ARDUINO_AFE_WAVE_CAPTURE_H
+
+#include	"AFE_NXP.h"
+
+/** WaveCapture class
+ *
+ * @tparam traits device traits of the AFE (e.g. NAFE13388_traits)
+ * @tparam N capture length in samples
+ */
+template<class traits, int N>
+class WaveCapture
+{
+public:
+	using raw_t	= AFE_base::raw_t;
+
+	enum Slope : uint8_t {
+		RISING,
+		FALLING,
+		EITHER,
+	};
+
+	enum State : uint8_t {
+		IDLE,		//	not armed
+		FILLING,	//	collecting pre-trigger samples
+		ARMED,		//	waiting trigger
+		TRIGGERED,	//	collecting post-trigger samples
+		DONE,		//	capture frozen
+	};
+
+	/** Create a WaveCapture instance
+	 *
+	 * @param afe_ AFE instance
+	 * @param ch_ logical channel number
+	 */
+	WaveCapture( NAFE_Base<traits>& afe_, int ch_ ) 
+		: afe( afe_ ), ch( ch_ ), level( 0 ), slope( RISING ), pre( N / 2 ), 
+		  state( IDLE ), head( 0 ), count( 0 ), post_remain( 0 ), previous( 0 ), first( true ), trigger_time( 0 )
+	{
+	}
+
+	/** Trigger condition
+	 *
+	 * @param level_ trigger level in ADC counts
+	 * @param slope_ RISING, FALLING or EITHER
+	 */
+	void	trigger( raw_t level_, Slope slope_ = RISING )
+	{
+		level	= level_;
+		slope	= slope_;
+	}
+
+	/** Pre-trigger window
+	 *
+	 * @param pre_trigger number of samples before trigger (0 ~ N - 1). Rest of N are post-trigger
+	 */
+	void	window( int pre_trigger )
+	{
+		pre	= (pre_trigger < 0) ? 0 : ((N <= pre_trigger) ? N - 1 : pre_trigger);
+	}
+
+	/** Start capture. Previous capture is discarded */
+	void	arm( void )
+	{
+		head	= 0;
+		count	= 0;
+		state	= pre ? FILLING : ARMED;
+		first	= true;
+	}
+
+	/** Feed a sample
+	 *
+	 *	Use this if the samples are acquired outside of this class
+	 *	
+	 * @param s ADC readout
+	 * @param timestamp cycle_counter() value of the sample
+	 * @return true when the capture is done
+	 */
+	bool	feed( raw_t s, uint32_t timestamp = 0 )
+	{
+		switch ( state )
+		{
+			case IDLE:
+			case DONE:
+				return state == DONE;
+			case FILLING:
+				put( s );
+				if ( pre <= count )
+					state	= ARMED;
+				break;
+			case ARMED:
+				if ( !first && crossed( previous, s ) )
+				{
+					state			= TRIGGERED;
+					post_remain		= N - pre - 1;
+					trigger_time	= timestamp;
+					
+					//	keep last "pre" samples as pre-trigger window
+					
+					if ( pre < count )
+						count	= pre;
+				}
+				put( s );
+				if ( (state == TRIGGERED) && !post_remain )
+					state	= DONE;
+				break;
+			case TRIGGERED:
+				put( s );
+				if ( !--post_remain )
+					state	= DONE;
+				break;
+		}
+
+		previous	= s;
+		first		= false;
+
+		return state == DONE;
+	}
+
+	/** Acquire a sample from AFE and feed it
+	 *
+	 * @param delay read delay, see AFE_base::read()
+	 * @return true when the capture is done
+	 */
+	bool	acquire( float delay = AFE_base::auto_delay )
+	{
+		const raw_t		s	= afe.template read<raw_t>( ch, delay );
+		
+		return feed( s, cycle_counter() );
+	}
+
+	/** Capture state */
+	State	status( void ) const	{ return state; }
+
+	/** Number of captured samples */
+	int		length( void ) const	{ return count; }
+
+	/** Number of samples before trigger in capture */
+	int		pre_trigger( void ) const	{ return pre; }
+
+	/** cycle_counter() value at trigger */
+	uint32_t	trigger_timestamp( void ) const	{ return trigger_time; }
+
+	/** Captured sample
+	 *
+	 * @param i index in time order, 0 for the oldest
+	 * @return ADC readout
+	 */
+	raw_t	sample( int i ) const
+	{
+		return buffer[ (head + N - count + i) % N ];
+	}
+
+private:
+	void	put( raw_t s )
+	{
+		buffer[ head ]	= s;
+		head			= (head + 1) % N;
+
+		if ( count < N )
+			count++;
+	}
+
+	bool	crossed( raw_t prev, raw_t s ) const
+	{
+		const bool	rise	= (prev < level) && (level <= s);
+		const bool	fall	= (prev > level) && (level >= s);
+
+		return (slope == RISING) ? rise : ((slope == FALLING) ? fall : (rise || fall));
+	}
+
+	NAFE_Base<traits>&	afe;
+	int				ch;
+	raw_t			level;
+	Slope			slope;
+	int				pre;
+
+	State			state;
+	raw_t			buffer[ N ];
+	int				head;
+	int				count;
+	int				post_remain;
+	raw_t			previous;
+	bool			first;
+	uint32_t		trigger_time;
+};
+
+#endif //	ARDUINO_AFE_WAVE_CAPTURE_H
@@ -0,0 +1,109 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Register bit field descriptors
+ *
+ *	A bit field is described by its register, bit offset and width in compile time.
+ *	get/set are constexpr and become just shift and mask operations.
+ *
+ *  Example:
+ *  @code
+ *	auto	cc0	= afe.fetch<NAFE13388::Register16::CH_CONFIG0>();	//	single SPI read
+ *
+ *	cc0.set<NAFE13388::CH_GAIN>( NAFE13388::PGA_GAIN_1 )
+ *	   .set<NAFE13388::HV_SEL >( 1 );
+ *
+ *	afe.store( cc0 );	//	single SPI write for both fields
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_BIT_FIELD_H
+#define ARDUINO_AFE_BIT_FIELD_H
+
+#include	<stdint.h>
+
+/** bit_field
+ *
+ * @tparam R register enum type
+ * @tparam r register which has the field
+ * @tparam offset LSB position of the field
+ * @tparam width field width in bits
+ */
+template<typename R, R r, int offset, int width>
+struct bit_field
+{
+	constexpr static R			reg		= r;
+	constexpr static int		shift	= offset;
+	constexpr static int		bits	= width;
+	constexpr static uint32_t	mask	= ((0x1UL << width) - 1) << offset;
+
+	/** Extract field value from register value */
+	constexpr static uint32_t	get( uint32_t v )
+	{
+		return (v & mask) >> offset;
+	}
+
+	/** Replace field value in register value */
+	constexpr static uint32_t	set( uint32_t v, uint32_t field )
+	{
+		return (v & ~mask) | ((field << offset) & mask);
+	}
+
+	/** Field value placed in register bit position */
+	constexpr static uint32_t	value( uint32_t field )
+	{
+		return (field << offset) & mask;
+	}
+};
+
+/** reg_image
+ *
+ *	Locally held register value.
+ *	Field updates are made on the local value and written to device at once.
+ *
+ * @tparam R register enum type
+ * @tparam r register
+ * @tparam V register value type
+ */
+template<typename R, R r, typename V>
+class reg_image
+{
+public:
+	constexpr static R	reg	= r;
+
+	constexpr reg_image( V v ) : value( v ), modified( false ) {}
+
+	/** Read a field */
+	template<class F>
+	constexpr V	get( void ) const
+	{
+		static_assert( F::reg == r, "bit field doesn't belong to this register" );
+		return F::get( value );
+	}
+
+	/** Write a field (local only) */
+	template<class F>
+	constexpr reg_image&	set( V field )
+	{
+		static_assert( F::reg == r, "bit field doesn't belong to this register" );
+
+		V	v	= F::set( value, field );
+
+		modified	|= (v != value);
+		value		 = v;
+
+		return *this;
+	}
+
+	/** Register value */
+	V		value;
+
+	/** Flag to show the value need to be written */
+	bool	modified;
+};
+
+#endif //	ARDUINO_AFE_BIT_FIELD_H
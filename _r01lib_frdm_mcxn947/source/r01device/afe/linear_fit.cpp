@@ -0,0 +1,108 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"linear_fit.h"
+#include	<math.h>
+
+static bool two_point_fit( const fit_point &p0, const fit_point &p1, fit_result &result )
+{
+	//	same as two-point calibration: slope by the span, intercept from the first point
+
+	const float	x_span	= p1.x - p0.x;
+
+	if ( x_span == 0.0f )
+		return false;
+
+	result.slope		= (p1.y - p0.y) / x_span;
+	result.intercept	= p0.y - result.slope * p0.x;
+
+	return true;
+}
+
+static bool least_squares_fit( const fit_point *points, int n, float sw, float swx, float swy, fit_result &result )
+{
+	//	sums around the mean to avoid cancellation in float
+
+	const float	mx	= swx / sw;
+	const float	my	= swy / sw;
+	float		sxx	= 0.0f;
+	float		sxy	= 0.0f;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		const float	dx	= points[ i ].x - mx;
+		const float	dy	= points[ i ].y - my;
+
+		sxx	+= points[ i ].weight * dx * dx;
+		sxy	+= points[ i ].weight * dx * dy;
+	}
+
+	if ( sxx <= 0.0f )
+		return false;
+
+	result.slope		= sxy / sxx;
+	result.intercept	= my - result.slope * mx;
+
+	return true;
+}
+
+bool linear_fit( const fit_point *points, int n, fit_result &result )
+{
+	float	sw		= 0.0f;
+	float	swx		= 0.0f;
+	float	swy		= 0.0f;
+	int		used[ 2 ];
+	int		n_used	= 0;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		sw	+= points[ i ].weight;
+		swx	+= points[ i ].weight * points[ i ].x;
+		swy	+= points[ i ].weight * points[ i ].y;
+
+		if ( 0.0f < points[ i ].weight )
+		{
+			if ( n_used < 2 )
+				used[ n_used ]	= i;
+
+			n_used++;
+		}
+	}
+
+	if ( sw <= 0.0f )
+		return false;
+
+	//	two points: the line goes through both, weights don't matter
+
+	const bool	fitted	= (n_used == 2)	? two_point_fit( points[ used[ 0 ] ], points[ used[ 1 ] ], result )
+										: least_squares_fit( points, n, sw, swx, swy, result );
+	if ( !fitted )
+		return false;
+
+	float	swrr	= 0.0f;
+
+	result.max_residual			= 0.0f;
+	result.max_residual_index	= 0;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		const float	r	= points[ i ].y - (result.slope * points[ i ].x + result.intercept);
+
+		swrr	+= points[ i ].weight * r * r;
+
+		if ( (0.0f < points[ i ].weight) && (result.max_residual < fabsf( r )) )
+		{
+			result.max_residual			= fabsf( r );
+			result.max_residual_index	= i;
+		}
+	}
+
+	result.rms_residual	= sqrtf( swrr / sw );
+
+	return true;
+}
@@ -0,0 +1,47 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Weighted least-squares straight line fit
+ *
+ *	Fits "y = slope * x + intercept" in single precision float. 
+ *	This code has no hardware dependency. 
+ */
+
+#ifndef ARDUINO_AFE_LINEAR_FIT_H
+#define ARDUINO_AFE_LINEAR_FIT_H
+
+#include	<stdint.h>
+
+typedef struct	_fit_point	{
+	float	x;
+	float	y;
+	float	weight;
+} fit_point;
+
+typedef struct	_fit_result	{
+	float	slope;
+	float	intercept;
+	float	rms_residual;		//	weighted RMS of (y - fitted y)
+	float	max_residual;		//	largest absolute residual
+	int		max_residual_index;	//	index of the point which has max_residual
+} fit_result;
+
+/** Weighted least-squares line fit
+ *
+ *	Weights are relative. Points with zero weight are ignored. 
+ *	Two or more points with different x are needed. 
+ *	With two points, the result is same as two-point calibration: 
+ *	slope = (y1 - y0) / (x1 - x0), intercept = y0 - slope * x0. 
+ *
+ * @param points array of points
+ * @param n number of points
+ * @param result reference to fit_result to store the result
+ * @return false if the fit cannot be done
+ */
+bool	linear_fit( const fit_point *points, int n, fit_result &result );
+
+#endif //	ARDUINO_AFE_LINEAR_FIT_H
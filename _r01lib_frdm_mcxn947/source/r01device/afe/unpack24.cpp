@@ -0,0 +1,87 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"unpack24.h"
+#include	<string.h>
+
+/** Big-endian word load, unaligned access is allowed */
+static inline uint32_t load_be32( const uint8_t *p )
+{
+	uint32_t	w;
+
+	memcpy( &w, p, sizeof( w ) );	//	single LDR on Cortex-M33
+
+	return __builtin_bswap32( w );
+}
+
+/** 4 samples from 12 bytes
+ *
+ *	r0 = b0 b1 b2 b3, r1 = b4 b5 b6 b7, r2 = b8 b9 b10 b11
+ *	Each sample is placed on upper 24 bits then arithmetic shift right does sign-extension
+ */
+static inline void unpack4( const uint8_t *src, int32_t &s0, int32_t &s1, int32_t &s2, int32_t &s3 )
+{
+	const uint32_t	r0	= load_be32( src     );
+	const uint32_t	r1	= load_be32( src + 4 );
+	const uint32_t	r2	= load_be32( src + 8 );
+
+	s0	= (int32_t)(r0                     ) >> 8;
+	s1	= (int32_t)((r0 << 24) | (r1 >>  8)) >> 8;
+	s2	= (int32_t)((r1 << 16) | (r2 >> 16)) >> 8;
+	s3	= (int32_t)((r2 <<  8)             ) >> 8;
+}
+
+static inline int32_t unpack1( const uint8_t *src )
+{
+	const uint32_t	r	= ((uint32_t)src[ 0 ] << 24) | ((uint32_t)src[ 1 ] << 16) | ((uint32_t)src[ 2 ] << 8);
+
+	return (int32_t)r >> 8;
+}
+
+void unpack24( const uint8_t *src, int32_t *dst, int n )
+{
+	int	i	= 0;
+
+	for ( ; i + 4 <= n; i += 4, src += 12 )
+		unpack4( src, dst[ i ], dst[ i + 1 ], dst[ i + 2 ], dst[ i + 3 ] );
+
+	for ( ; i < n; i++, src += 3 )
+		dst[ i ]	= unpack1( src );
+}
+
+void unpack24_scale( const uint8_t *src, float *dst, int n, float k )
+{
+	int		i	= 0;
+	int32_t	s0, s1, s2, s3;
+
+	for ( ; i + 4 <= n; i += 4, src += 12 )
+	{
+		unpack4( src, s0, s1, s2, s3 );
+
+		dst[ i     ]	= (float)s0 * k;
+		dst[ i + 1 ]	= (float)s1 * k;
+		dst[ i + 2 ]	= (float)s2 * k;
+		dst[ i + 3 ]	= (float)s3 * k;
+	}
+
+	for ( ; i < n; i++, src += 3 )
+		dst[ i ]	= (float)unpack1( src ) * k;
+}
+
+void unpack24_reference( const uint8_t *src, int32_t *dst, int n )
+{
+	for ( auto i = 0; i < n; i++, src += 3 )
+	{
+		int32_t	r0	= src[ 0 ];
+		int32_t	r1	= src[ 1 ];
+		int32_t	r2	= src[ 2 ];
+		int32_t	r	= ( (r0 << 24) | (r1 << 16) | (r2 << 8) );
+
+		dst[ i ]	= r >> 8;
+	}
+}
@@ -0,0 +1,47 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2025 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Block unpacking of 24 bit big-endian ADC data
+ *
+ *	Burst reads give 24 bit two's complement words packed in big-endian byte order.
+ *	unpack24() takes 4 samples from 3 word loads: byte order is swapped by REV
+ *	and the samples are cut out and sign-extended by shifts, no per-byte operation.
+ *	__builtin_bswap32() becomes single REV instruction on Cortex-M33 and bswap on host.
+ *	unpack24_reference() does the same byte by byte as SPI_for_AFE::read_r24(), for verification.
+ */
+
+#ifndef ARDUINO_AFE_UNPACK24_H
+#define ARDUINO_AFE_UNPACK24_H
+
+#include	<stdint.h>
+
+/** Unpack 24 bit big-endian samples
+ *
+ * @param src packed data, 3 * n bytes. No alignment required
+ * @param dst sign-extended samples
+ * @param n number of samples
+ */
+void	unpack24( const uint8_t *src, int32_t *dst, int n );
+
+/** Unpack and scale 24 bit big-endian samples
+ *
+ * @param src packed data, 3 * n bytes. No alignment required
+ * @param dst scaled samples: sample * k
+ * @param n number of samples
+ * @param k scaling coefficient, like coeff_uV
+ */
+void	unpack24_scale( const uint8_t *src, float *dst, int n, float k );
+
+/** Unpack 24 bit big-endian samples, byte by byte
+ *
+ * @param src packed data, 3 * n bytes
+ * @param dst sign-extended samples
+ * @param n number of samples
+ */
+void	unpack24_reference( const uint8_t *src, int32_t *dst, int n );
+
+#endif //	ARDUINO_AFE_UNPACK24_H
@@ -13,7 +13,7 @@ GPIO_base::GPIO_base( I2C& interface, uint8_t i2c_address, int nbits, const uint
 	n_ports( (nbits + 7) / 8 ),
 	arp( ar ),
 	auto_increment( ai ),
-	intfp( new I2C_device( interface, i2c_address ) )
+	intfp( std::in_place_type<I2C_device>, interface, i2c_address )
 {
 	init();
 }
@@ -23,7 +23,7 @@ GPIO_base::GPIO_base( SPI& interface, uint8_t dev_address, int nbits, const uint
 	n_ports( (nbits + 7) / 8 ),
 	arp( ar ),
 	auto_increment( ai ),
-	intfp( new GPIO_SPI( interface, dev_address ) )
+	intfp( std::in_place_type<GPIO_SPI>, interface, dev_address )
 {
 	init();
 }
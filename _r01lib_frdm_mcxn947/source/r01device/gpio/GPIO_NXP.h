@@ -11,7 +11,7 @@
 #include	"I2C_device.h"
 #include	"GPIO_SPI.h"
 #include	<stdint.h>
-#include	<memory>
+#include	<utility>
 
 /** Descriptors for accessing GPIO
  *
@@ -230,7 +230,7 @@ private:
 	const uint8_t*	arp;
 	const uint8_t	auto_increment;
 	bool			endian;
-	std::unique_ptr<Serial_device>	intfp;
+	InplacePtr<Serial_device, I2C_device, GPIO_SPI>	intfp;
 	
 	static constexpr int RESET_PIN	= D8;
 	static constexpr int ADDR_PIN	= D9;
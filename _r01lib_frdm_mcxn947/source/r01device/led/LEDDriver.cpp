@@ -15,8 +15,6 @@ LEDDriver::LEDDriver( uint8_t n_ch, uint8_t PWM_r, uint8_t oe ) :
 
 LEDDriver::~LEDDriver()
 {
-	if ( bp )
-		delete[]	bp;
 }
 
 void LEDDriver::pwm( uint8_t ch, float value )
@@ -36,7 +34,7 @@ void LEDDriver::pwm( float* values )
 			bp[ i ]	= (uint8_t)(values[ i ] * 255.0);
 	}
 	else {
-		uint8_t	v[ n_channel ];
+		uint8_t	v[ max_channels ];
 		for ( int i = 0; i < n_channel; i++ )
 			v[ i ]	= (uint8_t)(values[ i ] * 255.0);
 
@@ -52,17 +50,13 @@ void LEDDriver::flush( void )
 
 void LEDDriver::buffer_enable( bool flag )
 {
-	if ( bp ) {
-		delete[]	bp;
-		bp	= NULL;		
-	}
+	bp	= NULL;
 	
 	if ( flag ) {
-		bp	= new uint8_t[ n_channel ];	//	no error check done but execution will be aboerted in NEWLIB when the allocation failed
+		bp	= buffer;
 		for ( int i = 0; i < n_channel; i++ )
 			bp[ i ]	= 0x00;
 	}
-	
 }
 
 
@@ -232,7 +226,7 @@ void PCA995x_SPI::pwm( uint8_t ch, float value )
 
 void PCA995x_SPI::pwm( float* values )
 {
-	uint8_t	v[ n_channel ];
+	uint8_t	v[ max_channels ];
 	for ( int i = 0; i < n_channel; i++ )
 		v[ i ]	= (uint8_t)(values[ i ] * 255.0);
 
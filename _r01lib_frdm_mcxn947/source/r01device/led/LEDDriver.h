@@ -79,11 +79,15 @@ public:
 
 	const	uint8_t n_channel;
 
+	/** Maximum number of channels: PCA9955B, PCA9956B and PCA9957 have 16 or 24 channels */
+	constexpr static int	max_channels	= 24;
+
 protected:
 	const	uint8_t reg_PWM;
 	const	uint8_t oe_pin;
 private:
 	uint8_t	*bp;
+	uint8_t	buffer[ max_channels ];
 };
 
 
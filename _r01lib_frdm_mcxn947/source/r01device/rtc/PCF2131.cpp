@@ -7,12 +7,12 @@
 #include	"rtc/RTC_NXP.h"
 
 PCF2131::PCF2131( I2C& interface, uint8_t i2c_address )
-	: intfp( new I2C_device( interface, i2c_address ) )
+	: intfp( std::in_place_type<I2C_device>, interface, i2c_address )
 {
 }
 
 PCF2131::PCF2131( SPI& interface )
-	: intfp( new SPI_for_RTC( interface ) )
+	: intfp( std::in_place_type<SPI_for_RTC>, interface )
 {
 }
 
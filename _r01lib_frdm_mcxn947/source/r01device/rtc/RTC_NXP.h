@@ -11,7 +11,7 @@
 #include	"I2C_device.h"
 #include	<stdint.h>
 #include	<time.h>
-#include	<memory>
+#include	<utility>
 
 /** RTC_NXP class
  *	
@@ -336,7 +336,7 @@ private:
 		{ INT_A_MASK1, INT_A_MASK2, },
 		{ INT_B_MASK1, INT_B_MASK2, },
 	};
-	std::unique_ptr<Serial_device>	intfp;
+	InplacePtr<Serial_device, I2C_device, SPI_for_RTC>	intfp;
 };
 
 /** PCF85063A class
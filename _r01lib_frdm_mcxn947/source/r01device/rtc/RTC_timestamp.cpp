@@ -0,0 +1,65 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include	"rtc/RTC_timestamp.h"
+#include	<math.h>
+
+RTC_timestamp::RTC_timestamp( RTC_NXP& rtc_ ) : rtc( rtc_ ), anchor_cycles( 0 ), anchor_seconds( 0.0 )
+{
+}
+
+RTC_timestamp::~RTC_timestamp()
+{
+}
+
+void RTC_timestamp::sync( bool align )
+{
+	time_t		t	= rtc.time( NULL );
+	uint32_t	c	= cycle_counter();
+
+	if ( align )
+	{
+		const time_t	start		= t;
+		const uint32_t	timeout		= cycle_frequency() + cycle_frequency() / 10;
+		const uint32_t	begin		= c;
+		
+		while ( (t == start) && ((cycle_counter() - begin) < timeout) )
+		{
+			t	= rtc.time( NULL );
+			c	= cycle_counter();
+		}
+	}
+
+	anchor_cycles	= c;
+	anchor_seconds	= (double)t;
+}
+
+void RTC_timestamp::refresh( void )
+{
+	const uint32_t	now	= cycle_counter();
+
+	anchor_seconds	+= interval( anchor_cycles, now );
+	anchor_cycles	 = now;
+}
+
+double RTC_timestamp::seconds( uint32_t timestamp )
+{
+	return anchor_seconds + interval( anchor_cycles, timestamp );
+}
+
+void RTC_timestamp::to_timespec( uint32_t timestamp, struct timespec *ts )
+{
+	double	s		= seconds( timestamp );
+	double	integer	= floor( s );
+
+	ts->tv_sec	= (time_t)integer;
+	ts->tv_nsec	= (long)((s - integer) * 1e9);
+}
+
+double RTC_timestamp::interval( uint32_t from, uint32_t to )
+{
+	return (double)(int32_t)(to - from) / (double)cycle_frequency();
+}
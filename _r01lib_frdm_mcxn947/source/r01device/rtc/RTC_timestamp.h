@@ -0,0 +1,94 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_RTC_TIMESTAMP_H
+#define ARDUINO_RTC_TIMESTAMP_H
+
+#include	"rtc/RTC_NXP.h"
+#include	<stdint.h>
+#include	<time.h>
+
+/** RTC_timestamp class
+ *	
+ *  @class RTC_timestamp
+ *
+ *	Converts cycle_counter() timestamps into wall-clock time. 
+ *	The cycle counter is anchored to the RTC second boundary by sync(). 
+ *
+ *	Since the cycle counter is 32 bit, refresh() needs to be called at least 
+ *	every 2^31 cycles (14 seconds at 150MHz) to follow the counter wrap-around.
+ *	Timestamps to be converted need to be in 2^31 cycles from the last refresh. 
+ *
+ *  Example:
+ *  @code
+ *  I2C				i2c( I2C_SDA, I2C_SCL );
+ *  PCF85063A		rtc( i2c );
+ *  RTC_timestamp	wallclock( rtc );
+ *  
+ *  wallclock.sync();
+ *  
+ *  auto	s	= afe.read<NAFE13388::timestamped_t>( 0, 0.01 );
+ *  printf( "%.6lf, %ld\r\n", wallclock.seconds( s.timestamp ), s.raw );
+ *  @endcode
+ */
+
+class RTC_timestamp
+{
+public:
+	/** Create a RTC_timestamp instance
+	 *
+	 * @param rtc RTC to be used as time reference
+	 */
+	RTC_timestamp( RTC_NXP& rtc );
+
+	/** Destructor */
+	virtual ~RTC_timestamp();
+
+	/** Synchronize to RTC
+	 *
+	 *	Anchors the cycle counter to RTC time. 
+	 *	If align is true, this method waits for next RTC second change (max 1 second) 
+	 *	to get the anchor at the second boundary. 
+	 *
+	 * @param align wait RTC second change
+	 */
+	void	sync( bool align = true );
+
+	/** Move anchor to current cycle counter
+	 *
+	 *	Call this periodically to follow the cycle counter wrap-around
+	 */
+	void	refresh( void );
+
+	/** Convert a timestamp to seconds
+	 *
+	 * @param timestamp cycle_counter() value
+	 * @return seconds since epoch (same as time_t) in double
+	 */
+	double	seconds( uint32_t timestamp );
+
+	/** Convert a timestamp to timespec
+	 *
+	 * @param timestamp cycle_counter() value
+	 * @param ts pointer to timespec to store the result
+	 */
+	void	to_timespec( uint32_t timestamp, struct timespec *ts );
+
+	/** Interval between two timestamps
+	 *
+	 * @param from cycle_counter() value
+	 * @param to cycle_counter() value
+	 * @return interval in seconds
+	 */
+	static double	interval( uint32_t from, uint32_t to );
+
+private:
+	RTC_NXP&	rtc;
+	uint32_t	anchor_cycles;
+	double		anchor_seconds;
+};
+
+#endif //	ARDUINO_RTC_TIMESTAMP_H
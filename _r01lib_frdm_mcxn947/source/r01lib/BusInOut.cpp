@@ -25,11 +25,10 @@ BusInOut::BusInOut(
 	{
 		if ( b[ i ] == nc )
 		{
-			_bits[ i ]	= NULL;
 			continue;			
 		}
 		
-		_bits[ i ]	= new DigitalInOut( b[ i ] );
+		_bits[ i ].emplace<DigitalInOut>( b[ i ] );
 			
 		last_bit	= i;
 	}
@@ -39,11 +38,6 @@ BusInOut::BusInOut(
 
 BusInOut::~BusInOut()
 {	
-	for ( int i = 0; i < _width; i++ )
-	{
-		if ( _bits[ i ] )
-			delete _bits[ i ];
-	}
 }
 
 void BusInOut::config( int conf )
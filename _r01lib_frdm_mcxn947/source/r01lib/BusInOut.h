@@ -8,6 +8,7 @@
 #define ARDUINO_BUSINOUT_H
 
 #include "io.h"
+#include "InplacePtr.h"
 #include <stdint.h>
 
 /** BusInOut class
@@ -77,7 +78,7 @@ public:
 	operator	int();
 	
 private:
-	DigitalInOut*	_bits[ 8 ];
+	InplacePtr<DigitalInOut>	_bits[ 8 ];
 	uint8_t			_width;
 	uint8_t			_mode;
 };
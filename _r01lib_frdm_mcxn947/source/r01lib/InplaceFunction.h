@@ -0,0 +1,166 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_INPLACEFUNCTION_H
+#define R01LIB_INPLACEFUNCTION_H
+
+#include	<stddef.h>
+#include	<new>
+#include	<utility>
+#include	<type_traits>
+
+template<class Signature, size_t Capacity = 16>
+class InplaceFunction;
+
+/** InplaceFunction class
+ *
+ *  @class InplaceFunction
+ *
+ *	A fixed-capacity replacement of std::function
+ *	The callable (function pointer or lambda with its captures) is stored inside the instance, no heap is used.
+ *	A callable larger than Capacity bytes is rejected at compile time.
+ *
+ *  Example:
+ *  @code
+ *  InplaceFunction<void(int)>	f	= [ &count ]( int n ) { count += n; };
+ *
+ *  f( 3 );
+ *  @endcode
+ */
+template<class R, class... Args, size_t Capacity>
+class InplaceFunction<R( Args... ), Capacity>
+{
+public:
+	/** Create an empty InplaceFunction instance */
+	InplaceFunction() : ops( nullptr ) {}
+	InplaceFunction( std::nullptr_t ) : ops( nullptr ) {}
+
+	/** Create an InplaceFunction instance with a callable
+	 *
+	 * @param f function pointer, lambda or function object
+	 */
+	template<class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, InplaceFunction>::value>::type>
+	InplaceFunction( F&& f ) : ops( nullptr )
+	{
+		assign( std::forward<F>( f ) );
+	}
+
+	InplaceFunction( const InplaceFunction& rhs ) : ops( nullptr )
+	{
+		copy( rhs );
+	}
+
+	~InplaceFunction()
+	{
+		reset();
+	}
+
+	InplaceFunction&	operator=( const InplaceFunction& rhs )
+	{
+		if ( this != &rhs )
+		{
+			reset();
+			copy( rhs );
+		}
+
+		return *this;
+	}
+
+	InplaceFunction&	operator=( std::nullptr_t )
+	{
+		reset();
+		return *this;
+	}
+
+	template<class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, InplaceFunction>::value>::type>
+	InplaceFunction&	operator=( F&& f )
+	{
+		reset();
+		assign( std::forward<F>( f ) );
+
+		return *this;
+	}
+
+	/** Call the stored callable */
+	R	operator()( Args... args ) const
+	{
+		return ops->call( storage, std::forward<Args>( args )... );
+	}
+
+	/** Check a callable is stored */
+	explicit	operator bool() const	{ return ops != nullptr; }
+
+	/** Storage size */
+	constexpr static size_t	capacity	= Capacity;
+
+private:
+	typedef struct	_operations	{
+		R		(*call)( const void *p, Args&&... args );
+		void	(*copy)( void *dst, const void *src );
+		void	(*destroy)( void *p );
+	} operations;
+
+	template<class F>
+	static R	call_f( const void *p, Args&&... args )
+	{
+		return (*const_cast<F*>( static_cast<const F*>( p ) ))( std::forward<Args>( args )... );
+	}
+
+	template<class F>
+	static void	copy_f( void *dst, const void *src )
+	{
+		new ( dst ) F( *static_cast<const F*>( src ) );
+	}
+
+	template<class F>
+	static void	destroy_f( void *p )
+	{
+		static_cast<F*>( p )->~F();
+	}
+
+	template<class F>
+	void	assign( F&& f )
+	{
+		using	T	= typename std::decay<F>::type;
+
+		static_assert( sizeof( T ) <= Capacity, "InplaceFunction: callable too large, increase Capacity" );
+		static_assert( alignof( T ) <= alignof( max_align_t ), "InplaceFunction: callable alignment not supported" );
+
+		static const operations	o	= { call_f<T>, copy_f<T>, destroy_f<T> };
+
+		if constexpr ( std::is_pointer<typename std::remove_reference<F>::type>::value )	//	null function pointer makes empty
+		{
+			if ( !f )
+				return;
+		}
+
+		new ( storage ) T( std::forward<F>( f ) );
+		ops	= &o;
+	}
+
+	void	copy( const InplaceFunction& rhs )
+	{
+		if ( rhs.ops )
+		{
+			rhs.ops->copy( storage, rhs.storage );
+			ops	= rhs.ops;
+		}
+	}
+
+	void	reset( void )
+	{
+		if ( ops )
+		{
+			ops->destroy( storage );
+			ops	= nullptr;
+		}
+	}
+
+	alignas( max_align_t )	unsigned char	storage[ Capacity ];
+	const operations	*ops;
+};
+
+#endif // R01LIB_INPLACEFUNCTION_H
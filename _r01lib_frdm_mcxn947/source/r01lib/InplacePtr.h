@@ -0,0 +1,107 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_INPLACEPTR_H
+#define R01LIB_INPLACEPTR_H
+
+#include	<stddef.h>
+#include	<new>
+#include	<utility>
+#include	<type_traits>
+
+/** InplacePtr class
+ *
+ *  @class InplacePtr
+ *
+ *	An owning pointer which holds the object inside the instance, replacement of std::unique_ptr for
+ *	"one of a few known derived classes" members. The storage is sized for the largest of Types.
+ *	The object is destroyed when the InplacePtr is destroyed, no heap is used.
+ *
+ *  Example:
+ *  @code
+ *  InplacePtr<Serial_device, I2C_device, SPI_for_RTC>	intfp( std::in_place_type<I2C_device>, i2c, address );
+ *
+ *  intfp->write_r8( reg, val );
+ *  @endcode
+ */
+template<class Base, class... Types>
+class InplacePtr
+{
+public:
+	/** Create an empty InplacePtr instance */
+	InplacePtr() : ptr( nullptr ) {}
+
+	/** Create an InplacePtr instance and construct an object
+	 *
+	 * @param args arguments for the constructor of T
+	 */
+	template<class T, class... Args>
+	InplacePtr( std::in_place_type_t<T>, Args&&... args ) : ptr( nullptr )
+	{
+		emplace<T>( std::forward<Args>( args )... );
+	}
+
+	InplacePtr( const InplacePtr& )				= delete;
+	InplacePtr&	operator=( const InplacePtr& )	= delete;
+
+	~InplacePtr()
+	{
+		reset();
+	}
+
+	/** Construct an object. Old object is destroyed if exist
+	 *
+	 * @param args arguments for the constructor of T
+	 * @return pointer to the object
+	 */
+	template<class T, class... Args>
+	T*	emplace( Args&&... args )
+	{
+		static_assert( std::is_base_of<Base, T>::value, "InplacePtr: T must be derived from Base" );
+		static_assert( sizeof( T ) <= size, "InplacePtr: T must be one of Types" );
+		static_assert( alignof( T ) <= align, "InplacePtr: T must be one of Types" );
+
+		reset();
+
+		T	*p	= new ( storage ) T( std::forward<Args>( args )... );
+		ptr		= p;
+
+		return p;
+	}
+
+	/** Destroy the object */
+	void	reset( void )
+	{
+		if ( ptr )
+		{
+			ptr->~Base();
+			ptr	= nullptr;
+		}
+	}
+
+	Base*	get( void ) const			{ return ptr; }
+	Base*	operator->() const			{ return ptr; }
+	Base&	operator*() const			{ return *ptr; }
+	explicit	operator bool() const	{ return ptr != nullptr; }
+
+private:
+	template<class T, class... Rest>
+	constexpr static size_t	max_of( T v, Rest... rest )
+	{
+		if constexpr ( sizeof...( rest ) == 0 )
+			return v;
+		else
+			return (v < max_of( rest... )) ? max_of( rest... ) : v;
+	}
+
+	constexpr static size_t	size	= max_of( sizeof( Base ),  sizeof( Types )... );
+	constexpr static size_t	align	= max_of( alignof( Base ), alignof( Types )... );
+
+	alignas( align )	unsigned char	storage[ size ];
+	Base	*ptr;
+};
+
+#endif // R01LIB_INPLACEPTR_H
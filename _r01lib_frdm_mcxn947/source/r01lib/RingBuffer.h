@@ -0,0 +1,78 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_RINGBUFFER_H
+#define R01LIB_RINGBUFFER_H
+
+/** RingBuffer class
+ *
+ *  @class RingBuffer
+ *
+ *	A fixed-capacity FIFO. Storage is held inside the instance, no heap is used
+ *
+ * @note when the buffer is full, put() fails and the new item is dropped
+ */
+template<class T, int N>
+class RingBuffer
+{
+public:
+	/** Create an empty RingBuffer instance */
+	RingBuffer() : head( 0 ), tail( 0 ), count( 0 ) {}
+
+	/** Push an item
+	 *
+	 * @param item item to be stored
+	 * @return false if the buffer is full
+	 */
+	bool	put( const T& item )
+	{
+		if ( N <= count )
+			return false;
+
+		buffer[ head ]	= item;
+		head			= (head + 1) % N;
+		count++;
+
+		return true;
+	}
+
+	/** Pop an item
+	 *
+	 * @param item reference to get the oldest item
+	 * @return false if the buffer is empty
+	 */
+	bool	get( T& item )
+	{
+		if ( !count )
+			return false;
+
+		item	= buffer[ tail ];
+		tail	= (tail + 1) % N;
+		count--;
+
+		return true;
+	}
+
+	/** Number of stored items */
+	int		size( void ) const	{ return count; }
+
+	/** Buffer capacity */
+	int		capacity( void ) const	{ return N; }
+
+	/** Check empty */
+	bool	empty( void ) const	{ return !count; }
+
+	/** Discard all items */
+	void	clear( void )	{ head = tail = count = 0; }
+
+private:
+	T		buffer[ N ];
+	int		head;
+	int		tail;
+	int		count;
+};
+
+#endif // R01LIB_RINGBUFFER_H
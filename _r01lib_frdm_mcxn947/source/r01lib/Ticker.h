@@ -7,15 +7,14 @@
 #ifndef R01LIB_TICKER_H
 #define R01LIB_TICKER_H
 
-#include <functional>
-
 extern "C" {
 #include	"fsl_utick.h"
 }
 
-#include	<functional>
+#include	"InplaceFunction.h"
 
-using	ticker_callback_fp_t	= std::function<void(void)>;
+/** Callback type, a function pointer or a lambda with captures up to 16 bytes. No heap is used */
+using	ticker_callback_fp_t	= InplaceFunction<void(void)>;
 
 /** Ticker class
  *	
@@ -0,0 +1,66 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include	"heap_counter.h"
+#include	<stdlib.h>
+#include	<new>
+
+static volatile uint32_t	allocations		= 0;
+static volatile uint32_t	deallocations	= 0;
+
+bool heap_counter_enabled( void )
+{
+#ifdef	R01LIB_HEAP_COUNTER
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint32_t heap_allocations( void )
+{
+	return allocations;
+}
+
+uint32_t heap_deallocations( void )
+{
+	return deallocations;
+}
+
+void heap_counter_reset( void )
+{
+	allocations		= 0;
+	deallocations	= 0;
+}
+
+#ifdef	R01LIB_HEAP_COUNTER
+
+static void* counted_alloc( size_t size )
+{
+	allocations	= allocations + 1;
+	return malloc( size ? size : 1 );
+}
+
+static void counted_free( void *p )
+{
+	if ( !p )
+		return;
+
+	deallocations	= deallocations + 1;
+	free( p );
+}
+
+void* operator new( size_t size )									{ return counted_alloc( size ); }
+void* operator new[]( size_t size )									{ return counted_alloc( size ); }
+void* operator new( size_t size, const std::nothrow_t& ) noexcept	{ return counted_alloc( size ); }
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept	{ return counted_alloc( size ); }
+
+void operator delete( void *p ) noexcept							{ counted_free( p ); }
+void operator delete[]( void *p ) noexcept							{ counted_free( p ); }
+void operator delete( void *p, size_t ) noexcept					{ counted_free( p ); }
+void operator delete[]( void *p, size_t ) noexcept					{ counted_free( p ); }
+
+#endif	//	R01LIB_HEAP_COUNTER
@@ -0,0 +1,47 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_HEAP_COUNTER_H
+#define R01LIB_HEAP_COUNTER_H
+
+#include	<stdint.h>
+
+/** Heap counter
+ *
+ *	Debug counters of heap allocation. When R01LIB_HEAP_COUNTER is defined in the build,
+ *	global operator new/delete are replaced and every allocation through them is counted.
+ *	A steady-state loop is heap-free if heap_allocations() does not change across it.
+ *	Without R01LIB_HEAP_COUNTER, nothing is replaced and the counters stay zero.
+ *
+ * @note malloc() called directly from C code (newlib internals etc.) is not counted
+ *
+ *  Example:
+ *  @code
+ *  uint32_t	before	= heap_allocations();
+ *
+ *  for ( auto i = 0; i < 1000; i++ )
+ *  	afe.read( 0 );
+ *
+ *  printf( "allocations in loop: %lu\r\n", heap_allocations() - before );
+ *  @endcode
+ */
+
+/** Check the counter is built in
+ *
+ * @return true if R01LIB_HEAP_COUNTER is defined
+ */
+bool		heap_counter_enabled( void );
+
+/** Number of allocations since start or last heap_counter_reset() */
+uint32_t	heap_allocations( void );
+
+/** Number of deallocations since start or last heap_counter_reset() */
+uint32_t	heap_deallocations( void );
+
+/** Clear counters */
+void		heap_counter_reset( void );
+
+#endif // R01LIB_HEAP_COUNTER_H
@@ -37,7 +37,8 @@ extern "C" {
 #endif
 
 
-I2C::I2C( int sda, int scl, bool no_hw ) : Obj( true ), _sda( sda ), _scl( scl ), err_cb( nullptr )
+I2C::I2C( int sda, int scl, bool no_hw ) : Obj( true ), unit_base( nullptr ), _sda( sda ), _scl( scl ), err_cb( nullptr ),
+	async_handle_ready( false ), async_active( false ), async_reading( false )
 {
 	if ( no_hw )
 		return;
@@ -131,6 +132,12 @@ I2C::I2C( int sda, int scl, bool no_hw ) : Obj( true ), _sda( sda ), _scl( scl )
 
 I2C::~I2C()
 {
+	if ( !unit_base )
+		return;
+	
+	if ( async_active )
+		LPI2C_MasterTransferAbort( unit_base, &async_handle );
+
 	LPI2C_MasterDeinit( unit_base );
 }
 
@@ -151,6 +158,8 @@ status_t I2C::write( uint8_t address, const uint8_t *dp, int length, bool stop )
 {
 	status_t	r;
 	
+	async_wait();
+
 	if ( (r = write_core( address, dp, length, stop )) )
 		if ( err_cb )
 			err_cb( r, address );
@@ -162,6 +171,8 @@ status_t I2C::read( uint8_t address, uint8_t *dp, int length, bool stop )
 {
 	status_t	r;
 	
+	async_wait();
+
 	if ( (r = read_core( address, dp, length, stop )) )
 		if ( err_cb )
 			err_cb( r, address );
@@ -235,6 +246,9 @@ status_t I2C::reg_write( uint8_t targ, uint8_t reg, const uint8_t *dp, int lengt
 {
 	uint8_t	bp[ REG_RW_BUFFER_SIZE ];
 	
+	if ( (REG_RW_BUFFER_SIZE - 1) < length )
+		return last_status	= kStatus_InvalidArgument;
+	
 	bp[ 0 ]	= reg;
 	memcpy( (uint8_t *)bp + 1, (uint8_t *)dp, length );
 
@@ -302,6 +316,8 @@ void I2C::err_handling( status_t error, uint8_t address )
 bool I2C::ping( uint8_t addr )
 {
 	uint8_t	dummy	= 0;
+
+	async_wait();
 	return !write_core( addr, &dummy, 0 );
 }
 
@@ -349,3 +365,141 @@ status_t I2C::ccc_get( uint8_t ccc, uint8_t addr, uint8_t *dp, uint8_t length )
 	memset( dp, 0, length );
 	return kStatus_Success;
 }
+
+status_t I2C::async( uint8_t address, const uint8_t *wp, int w_length, uint8_t *rp, int r_length, async_cb_t callback )
+{
+	if ( !unit_base )
+		return kStatus_Fail;
+	
+	if ( !async_handle_ready )
+	{
+		LPI2C_MasterTransferCreateHandle( unit_base, &async_handle, async_transfer_done, this );	//	NVIC IRQ is enabled in this
+		async_handle_ready	= true;
+	}
+	
+	async_request	r;
+	
+	r.address	= address;
+	r.w_length	= w_length;
+	r.rp		= rp;
+	r.r_length	= r_length;
+	r.callback	= callback;
+	
+	if ( w_length <= async_copy_size )
+	{
+		if ( w_length )
+			memcpy( r.w_data, wp, w_length );
+
+		r.wp	= nullptr;
+	}
+	else
+	{
+		r.wp	= wp;
+	}
+	
+	uint32_t	irq_state	= DisableGlobalIRQ();
+	bool		queued		= async_queue.put( r );
+	
+	if ( queued && !async_active )
+		async_next();
+
+	EnableGlobalIRQ( irq_state );
+
+	return queued ? kStatus_Success : kStatus_LPI2C_Busy;
+}
+
+status_t I2C::async_reg_read( uint8_t targ, uint8_t reg, uint8_t *dp, int length, async_cb_t callback )
+{
+	return async( targ, &reg, sizeof( reg ), dp, length, callback );
+}
+
+int I2C::async_pending( void )
+{
+	uint32_t	irq_state	= DisableGlobalIRQ();
+	int			n			= async_queue.size() + (async_active ? 1 : 0);
+
+	EnableGlobalIRQ( irq_state );
+
+	return n;
+}
+
+void I2C::async_wait( void )
+{
+	while ( async_active )
+		;
+}
+
+void I2C::async_transfer_done( LPI2C_Type *base, lpi2c_master_handle_t *handle, status_t status, void *userData )
+{
+	static_cast<I2C *>( userData )->async_done( status );
+}
+
+/*	called in interrupt context or with interrupt disabled	*/
+
+void I2C::async_next( void )
+{
+	while ( async_queue.get( async_current ) )
+	{
+		async_request&	r	= async_current;
+		status_t		s;
+		
+		async_active	= true;
+		
+		if ( r.w_length || !r.r_length )
+		{
+			async_reading	= false;
+			s	= async_transfer( kLPI2C_Write, (uint8_t *)(r.wp ? r.wp : r.w_data), r.w_length, r.r_length ? kLPI2C_TransferNoStopFlag : kLPI2C_TransferDefaultFlag );
+		}
+		else
+		{
+			async_reading	= true;
+			s	= async_transfer( kLPI2C_Read, r.rp, r.r_length, kLPI2C_TransferDefaultFlag );
+		}
+
+		if ( kStatus_Success == s )
+			return;
+
+		if ( r.callback )
+			r.callback( s );
+	}
+
+	async_active	= false;
+}
+
+void I2C::async_done( status_t status )
+{
+	async_request&	r	= async_current;
+	
+	if ( (kStatus_Success == status) && !async_reading && r.r_length )
+	{
+		//	write phase finished without STOP, bus is kept. read with repeated-START
+
+		async_reading	= true;
+		status			= async_transfer( kLPI2C_Read, r.rp, r.r_length, kLPI2C_TransferDefaultFlag );
+
+		if ( kStatus_Success == status )
+			return;
+		
+		LPI2C_MasterStop( unit_base );
+	}
+	
+	if ( r.callback )
+		r.callback( status );
+
+	async_next();
+}
+
+status_t I2C::async_transfer( lpi2c_direction_t dir, uint8_t *dp, int length, uint32_t flags )
+{
+	lpi2c_master_transfer_t	xfer;
+	
+	xfer.flags			= flags;
+	xfer.slaveAddress	= async_current.address;
+	xfer.direction		= dir;
+	xfer.subaddress		= 0;
+	xfer.subaddressSize	= 0;
+	xfer.data			= dp;
+	xfer.dataSize		= length;
+
+	return LPI2C_MasterTransferNonBlocking( unit_base, &async_handle, &xfer );
+}
@@ -11,6 +11,8 @@
 #include	"fsl_lpi2c.h"
 #include	"obj.h"
 #include	"io.h"
+#include	"RingBuffer.h"
+#include	"InplaceFunction.h"
 
 /** I2C class
  *	
@@ -28,6 +30,15 @@ public:
 	/** defining pointer to NAK callback	*/
 	typedef void (*err_cb_ptr)( status_t status, uint8_t address );
 
+	/** callback for asynchronous transfer completion, called in interrupt context	*/
+	using async_cb_t	= InplaceFunction<void( status_t status ), 16>;
+
+	/** asynchronous transfer queue length	*/
+	constexpr static int	async_queue_length	= 8;
+
+	/** write data up to this size is copied into the request at queueing	*/
+	constexpr static int	async_copy_size		= 8;
+
 	/** constants for STOP-cindition setting  */
 	enum STOP_CONDITION
 	{
@@ -217,6 +228,40 @@ public:
 	 */
 	virtual status_t	ccc_get( uint8_t ccc, uint8_t addr, uint8_t *dp, uint8_t length );
 
+	/** Asynchronous transfer
+	 *	queues a write-then-read request and returns immediately.
+	 *	requests are processed in order by LPI2C interrupt. write and read are joined by repeated-START.
+	 *	write data up to async_copy_size bytes is copied, longer data and read buffer must be kept until completion.
+	 *	the callback is called in interrupt context, it must not call blocking methods of this I2C instance.
+	 *	err_callback is not called for asynchronous transfers, status is given to the callback.
+	 *
+	 * @param address target address
+	 * @param wp data to write, can be nullptr if w_length is 0
+	 * @param w_length write data length
+	 * @param rp buffer for read data, can be nullptr if r_length is 0
+	 * @param r_length read data length
+	 * @param callback (option) called with transfer status when the request completed
+	 * @return kStatus_Success if queued, kStatus_LPI2C_Busy if the queue is full
+	 */
+	virtual status_t	async( uint8_t address, const uint8_t *wp, int w_length, uint8_t *rp, int r_length, async_cb_t callback = nullptr );
+
+	/** Asynchronous register read
+	 *
+	 * @param targ target address
+	 * @param reg register address
+	 * @param dp buffer for read data, must be kept until completion
+	 * @param length data length
+	 * @param callback (option) called with transfer status when the request completed
+	 * @return kStatus_Success if queued, kStatus_LPI2C_Busy if the queue is full
+	 */
+	virtual status_t	async_reg_read( uint8_t targ, uint8_t reg, uint8_t *dp, int length, async_cb_t callback = nullptr );
+
+	/** Number of asynchronous requests not completed, including one in transfer */
+	int					async_pending( void );
+
+	/** Wait all asynchronous requests completed */
+	void				async_wait( void );
+
 	/** variable for reporting last state */
 	status_t				last_status;
 
@@ -230,6 +275,28 @@ private:
 	DigitalInOut			_sda;
 	DigitalInOut			_scl;
 	err_cb_ptr				err_cb;
+
+	typedef struct	_async_request	{
+		uint8_t			address;
+		uint8_t			w_data[ async_copy_size ];
+		const uint8_t	*wp;
+		int				w_length;
+		uint8_t			*rp;
+		int				r_length;
+		async_cb_t		callback;
+	} async_request;
+
+	static void	async_transfer_done( LPI2C_Type *base, lpi2c_master_handle_t *handle, status_t status, void *userData );
+	void		async_done( status_t status );
+	void		async_next( void );
+	status_t	async_transfer( lpi2c_direction_t dir, uint8_t *dp, int length, uint32_t flags );
+
+	RingBuffer<async_request, async_queue_length>	async_queue;
+	async_request			async_current;
+	lpi2c_master_handle_t	async_handle;
+	bool					async_handle_ready;
+	volatile bool			async_active;
+	bool					async_reading;
 };
 
 #endif // R01LIB_I2C_H
@@ -180,6 +180,10 @@ void init_mcu( void )
 #endif
 
 	UTICK_Init( UTICK0 );
+
+	DCB->DEMCR	|= DCB_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT	 = 0;
+	DWT->CTRL	|= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 void wait( float delayTime_sec )
@@ -187,6 +191,16 @@ void wait( float delayTime_sec )
 	SDK_DelayAtLeastUs( (uint32_t)(delayTime_sec * 1000000.0), CLOCK_GetCoreSysClkFreq() );
 }
 
+uint32_t cycle_counter( void )
+{
+	return DWT->CYCCNT;
+}
+
+uint32_t cycle_frequency( void )
+{
+	return CLOCK_GetCoreSysClkFreq();
+}
+
 void panic( const char *s )
 {
 	PRINTF( "error: %s", s );
@@ -9,9 +9,21 @@
 
 #include "r01lib.h"
 
-void	init_mcu( void );
-void	wait( float delayTime_sec );
-void 	panic( const char *s );
+void		init_mcu( void );
+void		wait( float delayTime_sec );
+void 		panic( const char *s );
+
+/** Free-running CPU cycle counter (DWT CYCCNT)
+ *
+ * @return counter value. It wraps around in 2^32 cycles
+ */
+uint32_t	cycle_counter( void );
+
+/** Cycle counter frequency
+ *
+ * @return counter frequency in Hz
+ */
+uint32_t	cycle_frequency( void );
 
 
 #endif // R01LIB_MCU_H
@@ -27,6 +27,10 @@ extern "C" {
 #include	"Ticker.h"
 #include	"InterruptIn.h"
 #include	"BusInOut.h"
+#include	"RingBuffer.h"
+#include	"InplaceFunction.h"
+#include	"InplacePtr.h"
+#include	"heap_counter.h"
 #include	"mcu.h"
 
 #include	<iostream>
@@ -136,6 +136,8 @@ void SPI::frequency( uint32_t frequency )
 
 	LPSPI_Deinit( EXAMPLE_LPSPI_MASTER_BASEADDR );
 	LPSPI_MasterInit( EXAMPLE_LPSPI_MASTER_BASEADDR, &masterConfig, LPSPI_MASTER_CLK_FREQ );
+
+	fast_path_setup();
 }
 
 void SPI::mode( uint8_t mode )
@@ -145,6 +147,8 @@ void SPI::mode( uint8_t mode )
 
 	LPSPI_Deinit( EXAMPLE_LPSPI_MASTER_BASEADDR );
 	LPSPI_MasterInit( EXAMPLE_LPSPI_MASTER_BASEADDR, &masterConfig, LPSPI_MASTER_CLK_FREQ );	
+
+	fast_path_setup();
 }
 
 status_t SPI::write( uint8_t *wp, uint8_t *rp, int length )
@@ -158,3 +162,84 @@ status_t SPI::write( uint8_t *wp, uint8_t *rp, int length )
 
 	return LPSPI_MasterTransferBlocking( EXAMPLE_LPSPI_MASTER_BASEADDR, &masterXfer );
 }
+
+void SPI::fast_path_setup( void )
+{
+	LPSPI_Type	*base	= EXAMPLE_LPSPI_MASTER_BASEADDR;
+	
+	//	CPOL, CPHA and PRESCALE are kept as set by LPSPI_MasterInit()
+	
+	constexpr uint32_t	clear_bits	= LPSPI_TCR_FRAMESZ_MASK | LPSPI_TCR_PCS_MASK | LPSPI_TCR_CONT_MASK | LPSPI_TCR_CONTC_MASK | LPSPI_TCR_RXMSK_MASK | LPSPI_TCR_TXMSK_MASK;
+
+	tcr_start	= (base->TCR & ~clear_bits) | LPSPI_TCR_FRAMESZ( 8 - 1 ) | EXAMPLE_LPSPI_MASTER_PCS_FOR_TRANSFER | LPSPI_TCR_CONT_MASK;
+	tcr_end		= tcr_start & ~LPSPI_TCR_CONT_MASK;
+	fifo_size	= LPSPI_GetTxFifoSize( base );
+}
+
+status_t SPI::write_fast( const uint8_t *wp, uint8_t *rp, int length )
+{
+	const uint8_t	frame_length	= length;
+
+	return write_frames( wp, rp, &frame_length, 1 );
+}
+
+status_t SPI::write_frames( const uint8_t *wp, uint8_t *rp, const uint8_t *lengths, int n )
+{
+	LPSPI_Type	*base	= EXAMPLE_LPSPI_MASTER_BASEADDR;
+	
+	int	rx_remain	= 0;
+	int	in_flight	= 0;
+
+	for ( auto i = 0; i < n; i++ )
+		rx_remain	+= lengths[ i ];
+
+	while ( base->SR & LPSPI_SR_MBF_MASK )
+		;
+
+	base->CR	 = base->CR | LPSPI_CR_RTF_MASK | LPSPI_CR_RRF_MASK;
+	base->SR	 = kLPSPI_AllStatusFlag;
+
+	auto	rx_pop	= [ & ]( void )
+	{
+		while ( (base->FSR & LPSPI_FSR_RXCOUNT_MASK) >> LPSPI_FSR_RXCOUNT_SHIFT )
+		{
+			*rp++	= base->RDR;
+			rx_remain--;
+			in_flight--;
+		}
+	};
+
+	//	TCR writes take TX FIFO entries but don't make RX data. 
+	//	Data words in flight are limited to RX FIFO depth to avoid overflow. 
+
+	auto	tx_push	= [ & ]( uint32_t v, bool is_tcr )
+	{
+		while ( (fifo_size <= ((base->FSR & LPSPI_FSR_TXCOUNT_MASK) >> LPSPI_FSR_TXCOUNT_SHIFT)) || (!is_tcr && ((int)fifo_size <= in_flight)) )
+			rx_pop();
+
+		if ( is_tcr )
+		{
+			base->TCR	= v;
+		}
+		else
+		{
+			base->TDR	= v;
+			in_flight++;
+		}
+	};
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		tx_push( tcr_start, true );
+
+		for ( auto j = 0; j < lengths[ i ]; j++ )
+			tx_push( *wp++, false );
+		
+		tx_push( tcr_end, true );
+	}
+
+	while ( rx_remain )
+		rx_pop();
+
+	return kStatus_Success;
+}
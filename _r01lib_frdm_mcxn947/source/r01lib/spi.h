@@ -65,11 +65,39 @@ public:
 	 */	
 	virtual status_t		write( uint8_t *wp, uint8_t *rp, int length );
 
+	/** Data transfer on SPI, register level
+	 *
+	 *	Transfers with pre-computed TCR and direct FIFO access, without SDK transfer routine. 
+	 *	CS is asserted during the transfer. 
+	 *  
+	 * @param wp data to write
+	 * @param rp data buffer for read
+	 * @param length transfer length
+	 */	
+	status_t				write_fast( const uint8_t *wp, uint8_t *rp, int length );
+
+	/** Multiple frame transfer on SPI, register level
+	 *
+	 *	Frames are queued in FIFO back to back. CS is negated between frames. 
+	 *	Data of all frames are packed in wp and rp.
+	 *  
+	 * @param wp data to write
+	 * @param rp data buffer for read
+	 * @param lengths array of frame lengths
+	 * @param n number of frames
+	 */	
+	status_t				write_frames( const uint8_t *wp, uint8_t *rp, const uint8_t *lengths, int n );
+
 	/** variable for reporting last state */
 	status_t				last_status;
 
 private:
+	void					fast_path_setup( void );
+
 	lpspi_master_config_t	masterConfig;
+	uint32_t				tcr_start;
+	uint32_t				tcr_end;
+	uint32_t				fifo_size;
 };
 
 #endif // R01LIB_SPI_H
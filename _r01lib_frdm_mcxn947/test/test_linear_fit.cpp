@@ -0,0 +1,148 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *	Host check of linear_fit() against a reference least-squares fit in double
+ */
+
+#include	"linear_fit.h"
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<math.h>
+
+static int	failures	= 0;
+
+static void check( bool condition, const char *name )
+{
+	printf( "%s: %s\r\n", condition ? "pass" : "FAIL", name );
+
+	if ( !condition )
+		failures++;
+}
+
+/** Reference: weighted normal equations in double */
+static void reference_fit( const fit_point *points, int n, double &slope, double &intercept )
+{
+	double	sw = 0.0, swx = 0.0, swy = 0.0, swxx = 0.0, swxy = 0.0;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		const double	w	= points[ i ].weight;
+		const double	x	= points[ i ].x;
+		const double	y	= points[ i ].y;
+
+		sw		+= w;
+		swx		+= w * x;
+		swy		+= w * y;
+		swxx	+= w * x * x;
+		swxy	+= w * x * y;
+	}
+
+	slope		= (sw * swxy - swx * swy) / (sw * swxx - swx * swx);
+	intercept	= (swy - slope * swx) / sw;
+}
+
+/** Original two-point formula of gain_offset_coeff( const ref_points &ref ), in float as linear_fit() */
+static void two_point_formula( const fit_point &low, const fit_point &high, float &slope, float &intercept )
+{
+	slope		= (high.y - low.y) / (high.x - low.x);
+	intercept	= low.y - slope * low.x;
+}
+
+static bool near( double value, double reference, double tolerance )
+{
+	return fabs( value - reference ) <= tolerance;
+}
+
+static void multi_point( void )
+{
+	//	ADC counts for input voltage: 16.3 bits/V like PGA gain 0.2, with offset and noise
+
+	constexpr double	k	= 838860.8;
+	constexpr double	b	= -1234.0;
+	const float			x[]	= { -10.0f, -5.0f, -1.0f, 0.0f, 1.0f, 5.0f, 10.0f };
+	const float			e[]	= { 3.0f, -2.0f, 5.0f, -4.0f, 1.0f, -6.0f, 2.0f };
+	constexpr int		n	= sizeof( x ) / sizeof( x[ 0 ] );
+
+	fit_point	p[ n ];
+	fit_result	r;
+	double		slope, intercept;
+
+	for ( auto i = 0; i < n; i++ )
+		p[ i ]	= { x[ i ], (float)round( k * x[ i ] + b + e[ i ] ), 1.0f };
+
+	check( linear_fit( p, n, r ), "multi-point: fit done" );
+	reference_fit( p, n, slope, intercept );
+	check( near( r.slope, slope, fabs( slope ) * 1e-6 ), "multi-point: slope matches reference" );
+	check( near( r.intercept, intercept, 1.0 ), "multi-point: intercept matches reference" );
+
+	//	weighted: a bad point with small weight
+
+	const float	w[]	= { 1.0f, 2.0f, 4.0f, 0.5f, 4.0f, 2.0f, 1.0f };
+
+	for ( auto i = 0; i < n; i++ )
+		p[ i ].weight	= w[ i ];
+
+	p[ 3 ].y	+= 500.0f;
+
+	check( linear_fit( p, n, r ), "weighted: fit done" );
+	reference_fit( p, n, slope, intercept );
+	check( near( r.slope, slope, fabs( slope ) * 1e-6 ), "weighted: slope matches reference" );
+	check( near( r.intercept, intercept, 1.0 ), "weighted: intercept matches reference" );
+	check( r.max_residual_index == 3, "weighted: max residual at the bad point" );
+}
+
+static void two_point( void )
+{
+	const fit_point	low		= { -9.5f,  -7970000.0f, 1.0f };
+	const fit_point	high	= {  9.5f,   7968123.0f, 1.0f };
+	float			slope, intercept;
+	fit_result		r;
+
+	two_point_formula( low, high, slope, intercept );
+
+	const fit_point	p[]	= { low, high };
+
+	check( linear_fit( p, 2, r ), "two-point: fit done" );
+	check( (r.slope == slope) && (r.intercept == intercept), "two-point: same as original formula" );
+
+	//	points with zero weight are ignored, other weights don't matter
+
+	const fit_point	q[]	= { { 3.0f, 1.0f, 0.0f }, { low.x, low.y, 0.3f }, { 0.0f, 5.0f, 0.0f }, { high.x, high.y, 7.0f } };
+
+	check( linear_fit( q, 4, r ), "two-point with zero weights: fit done" );
+	check( (r.slope == slope) && (r.intercept == intercept), "two-point with zero weights: same as original formula" );
+
+	//	original formula in double, as gain_offset_coeff() computed it
+
+	const double	slope_d		= ((double)high.y - low.y) / ((double)high.x - low.x);
+	const double	intercept_d	= low.y - slope_d * low.x;
+
+	check( near( r.slope, slope_d, fabs( slope_d ) * 1e-6 ), "two-point: slope close to double formula" );
+	check( near( r.intercept, intercept_d, 1.0 ), "two-point: intercept close to double formula" );
+}
+
+static void degenerate( void )
+{
+	const fit_point	same_x[]	= { { 1.0f, 2.0f, 1.0f }, { 1.0f, 3.0f, 1.0f }, { 1.0f, 4.0f, 1.0f } };
+	const fit_point	no_weight[]	= { { 1.0f, 2.0f, 0.0f }, { 2.0f, 3.0f, 0.0f } };
+	const fit_point	one[]		= { { 1.0f, 2.0f, 1.0f } };
+	fit_result		r;
+
+	check( !linear_fit( same_x, 3, r ),    "degenerate: same x rejected" );
+	check( !linear_fit( same_x, 2, r ),    "degenerate: two points with same x rejected" );
+	check( !linear_fit( no_weight, 2, r ), "degenerate: zero weights rejected" );
+	check( !linear_fit( one, 1, r ),       "degenerate: single point rejected" );
+}
+
+int main( void )
+{
+	multi_point();
+	two_point();
+	degenerate();
+
+	printf( "%d failure(s)\r\n", failures );
+
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
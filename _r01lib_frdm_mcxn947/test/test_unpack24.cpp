@@ -0,0 +1,123 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *	Host check of unpack24() and unpack24_scale() against unpack24_reference()
+ */
+
+#include	"unpack24.h"
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+
+static int	failures	= 0;
+
+static void check( bool condition, const char *name )
+{
+	printf( "%s: %s\r\n", condition ? "pass" : "FAIL", name );
+
+	if ( !condition )
+		failures++;
+}
+
+/** xorshift32, fixed seed for reproducible data */
+static uint32_t random32( void )
+{
+	static uint32_t	x	= 0x2545F491;
+
+	x	^= x << 13;
+	x	^= x >> 17;
+	x	^= x <<  5;
+
+	return x;
+}
+
+constexpr int		max_samples	= 4 * 1024 + 7;	//	covers every n % 4 beyond 4k + 3
+constexpr int		max_offset	= 4;
+constexpr int32_t	guard		= 0x5A5A5A5A;
+
+static uint8_t	packed[ 3 * max_samples + max_offset ];
+static int32_t	reference[ max_samples ];
+static int32_t	result[ max_samples + 1 ];
+static float	scaled[ max_samples + 1 ];
+
+/** Compare all sample counts 0 ~ max_samples at each source alignment */
+static void sweep( const char *name, float k )
+{
+	bool	unpack_ok	= true;
+	bool	scale_ok	= true;
+	bool	bounds_ok	= true;
+
+	for ( auto offset = 0; offset < max_offset; offset++ )
+	{
+		const uint8_t	*src	= packed + offset;
+
+		for ( auto n = 0; n <= max_samples; n++ )
+		{
+			result[ n ]	= guard;
+			scaled[ n ]	= (float)guard;
+
+			unpack24_reference( src, reference, n );
+			unpack24( src, result, n );
+			unpack24_scale( src, scaled, n, k );
+
+			unpack_ok	= unpack_ok && !memcmp( result, reference, n * sizeof( int32_t ) );
+			bounds_ok	= bounds_ok && (result[ n ] == guard) && (scaled[ n ] == (float)guard);
+
+			for ( auto i = 0; (i < n) && scale_ok; i++ )
+				scale_ok	= (scaled[ i ] == (float)reference[ i ] * k);
+		}
+	}
+
+	char	s[ 80 ];
+
+	snprintf( s, sizeof( s ), "%s: unpack24 matches reference", name );
+	check( unpack_ok, s );
+	snprintf( s, sizeof( s ), "%s: unpack24_scale matches reference", name );
+	check( scale_ok, s );
+	snprintf( s, sizeof( s ), "%s: no write beyond n samples", name );
+	check( bounds_ok, s );
+}
+
+static void random_data( void )
+{
+	for ( auto i = 0; i < (int)sizeof( packed ); i++ )
+		packed[ i ]	= (uint8_t)random32();
+
+	sweep( "random", 0.3814697f );
+}
+
+static void extreme_values( void )
+{
+	//	full scale, zero and values around sign bit, in every position of a 4 sample group
+
+	const uint32_t	v[]	= { 0x7FFFFF, 0x800000, 0xFFFFFF, 0x000000, 0x000001, 0x800001, 0x7FFFFE, 0x00FF00 };
+	constexpr int	nv	= sizeof( v ) / sizeof( v[ 0 ] );
+
+	for ( auto i = 0; i < (int)sizeof( packed ) / 3; i++ )
+	{
+		const uint32_t	s	= v[ (i + i / nv) % nv ];
+
+		packed[ i * 3     ]	= (uint8_t)(s >> 16);
+		packed[ i * 3 + 1 ]	= (uint8_t)(s >>  8);
+		packed[ i * 3 + 2 ]	= (uint8_t)(s      );
+	}
+
+	sweep( "extreme", 1.0f );
+
+	int32_t	d[ nv ];
+
+	unpack24_reference( packed, d, nv );
+	check( (d[ 0 ] == 8388607) && (d[ 1 ] == -8388608) && (d[ 2 ] == -1) && (d[ 3 ] == 0), "extreme: reference sign-extension" );
+}
+
+int main( void )
+{
+	random_data();
+	extreme_values();
+
+	printf( "%d failure(s)\r\n", failures );
+
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
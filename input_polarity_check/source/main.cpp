@@ -22,6 +22,7 @@ using enum	NAFE13388_UIM::Command;
 
 using 	raw_t			= NAFE13388_UIM::raw_t;
 using 	microvolt_t		= NAFE13388_UIM::microvolt_t;
+using 	timestamped_t	= NAFE13388_UIM::timestamped_t;
 
 constexpr int	CAL_FOR_PGA_0_2		= 0;
 
@@ -56,7 +57,8 @@ int main( void )
 	spi.frequency( 1000'000 );
 	spi.mode( 1 );
 
-	afe.begin();
+	if ( afe.begin() )
+		panic( "NAFE13388 couldn't get ready. Check power supply or pin conections\r\n" );
 	
 	out.printf( "part number   = %04lX (revision: %01X)\r\n", afe.part_number(), afe.revision_number() );
 	out.printf( "serial number = %llX\r\n", afe.serial_number() );
@@ -75,22 +77,30 @@ int main( void )
 //	recalibrate( 0, 14, 15 );
 	table_view( 32, 4, []( int v ){ out.printf( "  %8ld @ 0x%04X", afe.reg( v + GAIN_COEFF0 ), v + GAIN_COEFF0 ); }, [](){ out.printf( "\r\n" ); });
 
-	out.printf( "\r\ncount, A1P, A1N, A1P - A1N\r\n" );
+	out.printf( "\r\ntime, A1P, A1N, A1P - A1N\r\n" );
 
-//	raw_t			data;
-	microvolt_t		data;
-	long			count		= 0;
-	constexpr float read_delay	= 0.01;
+	timestamped_t	sample;
+	uint32_t		previous	= cycle_counter();
+	double			elapsed		= 0.0;
+	constexpr float read_delay	= NAFE13388_UIM::auto_delay;
+
+	afe.drdy_timestamp();
 
 	while ( true )
 	{
-		out.printf( " %8ld, ", count++ );
-		
 		for ( auto ch = 0; ch < afe.enabled_channels; ch++ )
 		{
-			data	= afe.read<microvolt_t>( ch, read_delay );
+			sample	= afe.read<timestamped_t>( ch, read_delay );
+			
+			if ( !ch )
+			{
+				elapsed		+= (double)(int32_t)(sample.timestamp - previous) / cycle_frequency();
+				previous	 = sample.timestamp;
+				out.printf( " %11.6lf, ", elapsed );
+			}
+			
 			out.screen( ch % 2 ? "\033[49m" : "\033[47m" );
-			out.printf( " %+8.5lf,", data * 0.000001 );
+			out.printf( " %+8.5lf,", sample.raw * afe.coeff_uV[ ch ] * 0.000001 );
 		}
 		out.printf( "\r\n" );
 
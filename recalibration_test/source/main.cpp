@@ -69,7 +69,8 @@ int main( void )
 	spi.frequency( 1000'000 );
 	spi.mode( 1 );
 
-	afe.begin();
+	if ( afe.begin() )
+		panic( "NAFE13388 couldn't get ready. Check power supply or pin conections\r\n" );
 	
 	out.printf( "part number   = %04lX (revision: %01X)\r\n", afe.part_number(), afe.revision_number() );
 	out.printf( "serial number = %llX\r\n", afe.serial_number() );
@@ -87,7 +88,7 @@ int main( void )
 
 	raw_t			data;
 	long			count		= 0;
-	constexpr float read_delay	= 0.01;
+	constexpr float read_delay	= NAFE13388_UIM::auto_delay;
 
 	while ( true )
 	{